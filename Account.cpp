@@ -3,23 +3,34 @@
  *
  * This file implements the functions declared in Account.h.
  * It handles the addition of borrowed books, renewing and returning books
- * (including calculating fines for overdue returns), and maintaining the borrowing history.
+ * (including calculating fines for overdue returns).
+ * Fines are kept in integer paise to avoid floating-point drift.
  */
 
 #include "Account.h"
+#include <climits>
 #include <cmath>
-#include <iostream>
 using namespace std;
 
-Account::Account() : fine(0.0) {}
+Account::Account() : borrowPeriodMinutes(0), fineCents(0) {}
+
+void Account::setBorrowPeriod(int days) {
+    borrowPeriodMinutes = static_cast<long long>(days) * 24 * 60;
+    dueTimes.clear();
+    for (const auto &bb : borrowedBooks)
+        dueTimes.insert({bb.borrowTime + borrowPeriodMinutes, bb.bookId});
+}
 
 void Account::addBorrowedBook(int bookId, long long borrowTime) {
     borrowedBooks.push_back({bookId, borrowTime});
+    dueTimes.insert({borrowTime + borrowPeriodMinutes, bookId});
 }
 
 bool Account::renewBorrowedBook(int bookId, long long newBorrowTime) {
     for (auto &bb : borrowedBooks) {
         if (bb.bookId == bookId) {
+            dueTimes.erase({bb.borrowTime + borrowPeriodMinutes, bookId});
+            dueTimes.insert({newBorrowTime + borrowPeriodMinutes, bookId});
             bb.borrowTime = newBorrowTime;
             return true;
         }
@@ -27,7 +38,22 @@ bool Account::renewBorrowedBook(int bookId, long long newBorrowTime) {
     return false;
 }
 
-bool Account::returnBook(int bookId, long long returnTime, int borrowPeriodDays, int finePerDay) {
+// Ends a loan without a return: no history record and no fine. Used when the
+// book itself is withdrawn from the catalog.
+bool Account::dropBorrowedBook(int bookId) {
+    for (auto it = borrowedBooks.begin(); it != borrowedBooks.end(); ++it) {
+        if (it->bookId == bookId) {
+            dueTimes.erase({it->borrowTime + borrowPeriodMinutes, bookId});
+            borrowedBooks.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+// On success, record receives the history entry for the return.
+bool Account::returnBook(int bookId, long long returnTime, int borrowPeriodDays, int finePerDay,
+                         BorrowHistory &record) {
     long long allowedTime = static_cast<long long>(borrowPeriodDays) * 24 * 60;
     for (auto it = borrowedBooks.begin(); it != borrowedBooks.end(); ++it) {
         if (it->bookId == bookId) {
@@ -35,18 +61,17 @@ bool Account::returnBook(int bookId, long long returnTime, int borrowPeriodDays,
             int overdueDays = 0;
             double fineCharged = 0.0;
             if (overdue > 0) {
-                overdueDays = static_cast<int>(ceil(overdue / (24.0 * 60)));
-                fineCharged = overdueDays * finePerDay;
-                fine += fineCharged;
+                overdueDays = static_cast<int>((overdue + 24 * 60 - 1) / (24 * 60));
+                long long chargedCents = static_cast<long long>(overdueDays) * finePerDay * 100;
+                fineCents += chargedCents;
+                fineCharged = chargedCents / 100.0;
             }
-            history.push_back({bookId, it->borrowTime, returnTime, overdueDays, fineCharged});
+            record = {bookId, it->borrowTime, returnTime, overdueDays, fineCharged};
+            dueTimes.erase({it->borrowTime + borrowPeriodMinutes, bookId});
             borrowedBooks.erase(it);
-            if (overdueDays > 0)
-                cout << "Book was overdue by " << overdueDays << " days. Fine incurred: " << fineCharged << endl;
             return true;
         }
     }
-    cout << "No record found for this book in your borrowed list." << endl;
     return false;
 }
 
@@ -58,22 +83,40 @@ const vector<BorrowedBook> &Account::getBorrowedBooks() const {
     return borrowedBooks;
 }
 
+// Every loan shares the account's period, so the earliest due loan is also the
+// oldest borrow.
+long long Account::getOldestBorrowTime() const {
+    return dueTimes.empty() ? LLONG_MAX : dueTimes.begin()->first - borrowPeriodMinutes;
+}
+
+long long Account::getNextDueTime() const {
+    return dueTimes.empty() ? LLONG_MAX : dueTimes.begin()->first;
+}
+
+// Open loans as (due time, bookId), earliest due first.
+const set<pair<long long, int>> &Account::getLoansByDueTime() const {
+    return dueTimes;
+}
+
 double Account::getFine() const {
-    return fine;
+    return fineCents / 100.0;
 }
 
-void Account::payFine() {
-    fine = 0.0;
+long long Account::getFineCents() const {
+    return fineCents;
 }
 
-void Account::setFine(double f) {
-    fine = f;
+void Account::payFine() {
+    fineCents = 0;
 }
 
-const vector<BorrowHistory> &Account::getHistory() const {
-    return history;
+void Account::setFine(double f) {
+    fineCents = llround(f * 100);
 }
 
-void Account::addHistoryRecord(const BorrowHistory &record) {
-    history.push_back(record);
+// Approximate bytes held by the account, counting a set node as the value
+// plus three pointers and a colour word.
+size_t Account::memoryFootprint() const {
+    return sizeof(Account) + borrowedBooks.capacity() * sizeof(BorrowedBook) +
+           dueTimes.size() * (sizeof(pair<long long, int>) + 4 * sizeof(void *));
 }
@@ -7,14 +7,20 @@
  *
  * The Account class manages a user’s borrowing activity, including:
  * - Adding a borrowed book.
- * - Renewing and returning books (with overdue fine calculations).
- * - Storing a history of transactions.
- * - Tracking the current outstanding fine.
+ * - Renewing and returning books (with overdue fine calculations). The
+ *   history record for a return is handed back to the caller; completed loans
+ *   are kept in the library-wide HistoryStore, not in the Account.
+ * - Tracking the current outstanding fine (in integer paise).
+ * - Keeping the open loans ordered by due time, so borrowing checks and
+ *   overdue notifications only look at the loans that are actually due.
  */
 
 #ifndef ACCOUNT_H
 #define ACCOUNT_H
 
+#include <cstddef>
+#include <set>
+#include <utility>
 #include <vector>
 using namespace std;
 
@@ -34,25 +40,34 @@ struct BorrowHistory {
 class Account {
 public:
     Account();
+
+    void setBorrowPeriod(int days);
     
     void addBorrowedBook(int bookId, long long borrowTime);
     bool renewBorrowedBook(int bookId, long long newBorrowTime);
-    bool returnBook(int bookId, long long returnTime, int borrowPeriodDays, int finePerDay);
+    bool returnBook(int bookId, long long returnTime, int borrowPeriodDays, int finePerDay,
+                    BorrowHistory &record);
+    bool dropBorrowedBook(int bookId);
     
     int getBorrowedCount() const;
     const vector<BorrowedBook> &getBorrowedBooks() const;
+
+    long long getOldestBorrowTime() const;
+    long long getNextDueTime() const;
+    const set<pair<long long, int>> &getLoansByDueTime() const;
     
     double getFine() const;
+    long long getFineCents() const;
     void payFine();
     void setFine(double f);
-    
-    const vector<BorrowHistory> &getHistory() const;
-    void addHistoryRecord(const BorrowHistory &record);
+
+    size_t memoryFootprint() const;
 
 private:
     vector<BorrowedBook> borrowedBooks;
-    vector<BorrowHistory> history;
-    double fine;
+    set<pair<long long, int>> dueTimes; // (due time, bookId)
+    long long borrowPeriodMinutes;
+    long long fineCents;
 };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,143 @@
+/*
+ * AccountPager.cpp
+ *
+ * This file implements the page file declared in AccountPager.h.
+ */
+
+#include "AccountPager.h"
+#include <cstdio>
+#include <vector>
+using namespace std;
+
+AccountPager::AccountPager() : fileBytes(0), liveBytes(0) {}
+
+AccountPager::~AccountPager() {
+    close();
+}
+
+// Starts an empty page file, replacing any left over from an earlier run.
+bool AccountPager::open(const string &pagePath) {
+    close();
+    path = pagePath;
+    file.open(path, ios::in | ios::out | ios::trunc | ios::binary);
+    return file.is_open();
+}
+
+void AccountPager::close() {
+    if (!file.is_open())
+        return;
+    file.close();
+    remove(path.c_str());
+    entries.clear();
+    usernames.clear();
+    fileBytes = liveBytes = 0;
+}
+
+bool AccountPager::isOpen() const {
+    return file.is_open();
+}
+
+// Lines longer than the length field allows are refused, which simply keeps
+// that user resident.
+bool AccountPager::store(int userId, const string &username, const string &line) {
+    if (line.size() >= (1u << LENGTH_BITS))
+        return false;
+    file.clear();
+    file.seekp(fileBytes);
+    file.write(line.data(), line.size());
+    if (!file)
+        return false;
+    entries[userId] = static_cast<uint64_t>(fileBytes) << LENGTH_BITS | line.size();
+    usernames.emplace(hash<string>()(username), userId);
+    fileBytes += line.size();
+    liveBytes += line.size();
+    return true;
+}
+
+bool AccountPager::fetch(int userId, string &line) const {
+    auto it = entries.find(userId);
+    if (it == entries.end())
+        return false;
+    line.resize(it->second & ((1u << LENGTH_BITS) - 1));
+    file.clear();
+    file.seekg(it->second >> LENGTH_BITS);
+    file.read(&line[0], line.size());
+    return static_cast<bool>(file);
+}
+
+void AccountPager::erase(int userId, const string &username) {
+    auto it = entries.find(userId);
+    if (it == entries.end())
+        return;
+    liveBytes -= it->second & ((1u << LENGTH_BITS) - 1);
+    entries.erase(it);
+    auto range = usernames.equal_range(hash<string>()(username));
+    for (auto u = range.first; u != range.second; ++u) {
+        if (u->second == userId) {
+            usernames.erase(u);
+            break;
+        }
+    }
+    if (fileBytes > 2 * liveBytes + (1 << 20))
+        compact();
+}
+
+bool AccountPager::contains(int userId) const {
+    return entries.count(userId) != 0;
+}
+
+// Hash matches are confirmed against the username field (the fourth) of the
+// stored line.
+int AccountPager::findUsername(const string &username) const {
+    auto range = usernames.equal_range(hash<string>()(username));
+    string line;
+    for (auto it = range.first; it != range.second; ++it) {
+        if (!fetch(it->second, line))
+            continue;
+        size_t start = 0;
+        for (int field = 0; field < 3 && start != string::npos; field++)
+            start = line.find(',', start) + 1;
+        if (line.compare(start, line.find(',', start) - start, username) == 0)
+            return it->second;
+    }
+    return 0;
+}
+
+size_t AccountPager::size() const {
+    return entries.size();
+}
+
+// Rough in-memory cost: a tree node per entry plus a hash node and bucket.
+size_t AccountPager::memoryBytes() const {
+    return entries.size() * (sizeof(map<int, uint64_t>::value_type) + 32 + sizeof(size_t) + sizeof(int) + 16);
+}
+
+const map<int, uint64_t> &AccountPager::index() const {
+    return entries;
+}
+
+// Rewrites the live lines to a fresh file and swaps it in.
+void AccountPager::compact() {
+    string tmpPath = path + ".tmp";
+    ofstream out(tmpPath, ios::binary | ios::trunc);
+    long long offset = 0;
+    string line;
+    map<int, uint64_t> moved;
+    for (const auto &entry : entries) {
+        fetch(entry.first, line);
+        out.write(line.data(), line.size());
+        moved[entry.first] = static_cast<uint64_t>(offset) << LENGTH_BITS | line.size();
+        offset += line.size();
+    }
+    out.close();
+    if (!out)
+        return;
+    file.close();
+    if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+        file.open(path, ios::in | ios::out | ios::binary);
+        return;
+    }
+    file.open(path, ios::in | ios::out | ios::binary);
+    entries.swap(moved);
+    fileBytes = liveBytes = offset;
+}
@@ -0,0 +1,63 @@
+/*
+ * AccountPager.h
+ *
+ * This file declares the AccountPager class, the on-disk store that holds
+ * user accounts paged out of memory when the Library runs under a memory
+ * budget.
+ *
+ * A paged-out user is kept as one line in the same format as users.csv,
+ * appended to a scratch page file. In memory only a small index remains: the
+ * line's position and length packed into one word (ordered by user ID, so
+ * listings can merge it with the resident users), and a map from username
+ * hash to user ID for logins, confirmed against the stored line. When a user
+ * is read back their line becomes garbage; once garbage outweighs the live
+ * lines the file is rewritten.
+ *
+ * The page file only lives as long as the process. Paged-out users are
+ * written to users.csv by saveData like everyone else.
+ */
+
+#ifndef ACCOUNTPAGER_H
+#define ACCOUNTPAGER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unordered_map>
+using namespace std;
+
+class AccountPager {
+public:
+    AccountPager();
+    ~AccountPager();
+
+    bool open(const string &path);
+    void close();
+    bool isOpen() const;
+
+    bool store(int userId, const string &username, const string &line);
+    bool fetch(int userId, string &line) const;
+    void erase(int userId, const string &username);
+
+    bool contains(int userId) const;
+    int findUsername(const string &username) const;
+    size_t size() const;
+    size_t memoryBytes() const;
+    const map<int, uint64_t> &index() const;
+
+private:
+    static const int LENGTH_BITS = 16;
+
+    void compact();
+
+    string path;
+    mutable fstream file;
+    map<int, uint64_t> entries;
+    unordered_multimap<size_t, int> usernames;
+    long long fileBytes;
+    long long liveBytes;
+};
+
+#endif
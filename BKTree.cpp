@@ -0,0 +1,119 @@
+/*
+ * BKTree.cpp
+ *
+ * This file implements the BKTree and EditDistance classes declared in
+ * BKTree.h.
+ */
+
+#include "BKTree.h"
+#include <algorithm>
+#include <cstring>
+using namespace std;
+
+EditDistance::EditDistance(const string &word) : word(word) {
+    memset(peq, 0, sizeof(peq));
+    if (word.size() <= 64) {
+        for (size_t i = 0; i < word.size(); i++)
+            peq[static_cast<unsigned char>(word[i])] |= uint64_t(1) << i;
+    }
+}
+
+// Myers (1999) as formulated for edit distance by Hyyrö: bit i of Pv/Mv is
+// set when the cell in row i + 1 of the current column is one more/less than
+// the cell above it. Only the last row's score is tracked.
+int EditDistance::to(const string &other) const {
+    size_t m = word.size();
+    if (m == 0)
+        return static_cast<int>(other.size());
+    if (m > 64)
+        return toByTable(other);
+    uint64_t pv = ~uint64_t(0), mv = 0;
+    uint64_t last = uint64_t(1) << (m - 1);
+    int score = static_cast<int>(m);
+    for (char ch : other) {
+        uint64_t eq = peq[static_cast<unsigned char>(ch)];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & last)
+            score++;
+        else if (mh & last)
+            score--;
+        // The top row is 0, 1, 2, ..., so every column starts one higher.
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+    return score;
+}
+
+int EditDistance::toByTable(const string &other) const {
+    vector<int> row(other.size() + 1);
+    for (size_t j = 0; j <= other.size(); j++)
+        row[j] = static_cast<int>(j);
+    for (size_t i = 1; i <= word.size(); i++) {
+        int diagonal = row[0];
+        row[0] = static_cast<int>(i);
+        for (size_t j = 1; j <= other.size(); j++) {
+            int above = row[j];
+            row[j] = min({row[j] + 1, row[j - 1] + 1, diagonal + (word[i - 1] != other[j - 1])});
+            diagonal = above;
+        }
+    }
+    return row[other.size()];
+}
+
+bool BKTree::insert(const string &word) {
+    if (nodes.empty()) {
+        nodes.push_back({word, {}});
+        return true;
+    }
+    EditDistance distance(word);
+    size_t at = 0;
+    for (;;) {
+        int d = distance.to(nodes[at].word);
+        if (d == 0)
+            return false;
+        auto &children = nodes[at].children;
+        auto child = find_if(children.begin(), children.end(), [d](const pair<int, size_t> &c) {
+            return c.first == d;
+        });
+        if (child == children.end()) {
+            children.push_back({d, nodes.size()});
+            nodes.push_back({word, {}});
+            return true;
+        }
+        at = child->second;
+    }
+}
+
+// Every word within maxDistance edits of word, in no particular order.
+vector<string> BKTree::find(const string &word, int maxDistance) const {
+    vector<string> matches;
+    if (nodes.empty())
+        return matches;
+    EditDistance distance(word);
+    vector<size_t> pending(1, 0);
+    while (!pending.empty()) {
+        const Node &node = nodes[pending.back()];
+        pending.pop_back();
+        int d = distance.to(node.word);
+        if (d <= maxDistance)
+            matches.push_back(node.word);
+        for (const auto &child : node.children) {
+            if (child.first >= d - maxDistance && child.first <= d + maxDistance)
+                pending.push_back(child.second);
+        }
+    }
+    return matches;
+}
+
+size_t BKTree::size() const {
+    return nodes.size();
+}
+
+void BKTree::clear() {
+    nodes.clear();
+}
@@ -0,0 +1,66 @@
+/*
+ * BKTree.h
+ *
+ * This file declares the BKTree class, which finds the catalog words within
+ * a few typing mistakes of a search word, and EditDistance, the Levenshtein
+ * distance kernel it is built on.
+ *
+ * A BK-tree stores each word under the first word it is inserted below, on
+ * the branch labelled with their edit distance. Because edit distance obeys
+ * the triangle inequality, a query at distance d from a node only has to
+ * follow the branches labelled d - k to d + k to find every word within k
+ * edits, so most of the dictionary is never compared.
+ *
+ * EditDistance prepares a word once and then measures its distance to many
+ * others with Myers' bit-parallel algorithm: one pass over the other word
+ * with a handful of 64-bit operations per character, instead of filling a
+ * table of length x length cells. Words longer than 64 bytes fall back to
+ * the table.
+ *
+ * Words are only ever added. A word whose books have all gone stays in the
+ * tree and is filtered out by the caller.
+ */
+
+#ifndef BKTREE_H
+#define BKTREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+class EditDistance {
+public:
+    explicit EditDistance(const string &word);
+
+    // Levenshtein distance (insertions, deletions and substitutions) from
+    // the prepared word to other.
+    int to(const string &other) const;
+
+private:
+    int toByTable(const string &other) const;
+
+    string word;
+    uint64_t peq[256];
+};
+
+class BKTree {
+public:
+    // Returns false if the word is already in the tree.
+    bool insert(const string &word);
+    vector<string> find(const string &word, int maxDistance) const;
+    size_t size() const;
+    void clear();
+
+private:
+    struct Node {
+        string word;
+        vector<pair<int, size_t>> children;
+    };
+
+    vector<Node> nodes;
+};
+
+#endif
@@ -0,0 +1,237 @@
+/*
+ * BatchRunner.cpp
+ *
+ * This file implements the headless batch mode declared in BatchRunner.h.
+ * Operations go straight to the Library API and their OpStatus is tallied.
+ * Without quiet, each operation's outcome is printed and listing commands are
+ * rendered through LibraryConsole with every page printed and no prompts;
+ * with quiet, listings are skipped (searches still run) and only the final
+ * summary is shown.
+ */
+
+#include "BatchRunner.h"
+#include "LibraryConsole.h"
+#include "Utility.h"
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+using namespace std;
+
+static vector<string> splitFields(const string &line) {
+    vector<string> fields;
+    stringstream ss(line);
+    string field;
+    while (getline(ss, field, '|'))
+        fields.push_back(trim(field));
+    // getline drops a trailing empty field ("a|b|").
+    if (!line.empty() && line.back() == '|')
+        fields.push_back("");
+    return fields;
+}
+
+// Parses "3,7,9" into book IDs.
+static vector<int> parseIds(const string &field) {
+    vector<int> ids;
+    stringstream ss(field);
+    string id;
+    while (getline(ss, id, ','))
+        ids.push_back(stoi(trim(id)));
+    return ids;
+}
+
+// Parses "1:3,2:7" into (user ID, book ID) pairs.
+static vector<LoanRequest> parseLoans(const string &field) {
+    vector<LoanRequest> loans;
+    stringstream ss(field);
+    string pairText;
+    while (getline(ss, pairText, ',')) {
+        size_t colon = pairText.find(':');
+        if (colon == string::npos) throw invalid_argument("expected user:book");
+        loans.push_back({stoi(trim(pairText.substr(0, colon))), stoi(trim(pairText.substr(colon + 1)))});
+    }
+    return loans;
+}
+
+// Returns the number of lines that could not be executed (unknown command,
+// wrong number of fields, bad number or unknown user), or -1 if the file
+// could not be opened.
+int runBatch(Library &lib, VirtualClock &clock, const string &path, bool quiet) {
+    ifstream in(path);
+    if (!in.is_open()) {
+        cerr << "Cannot open batch file " << path << endl;
+        return -1;
+    }
+    LibraryConsole console(lib);
+    console.setPrompting(false);
+    map<string, long long> executed;
+    map<OpStatus, long long> refused;
+    vector<string> rejected;
+    long long commands = 0;
+    int lineNumber = 0;
+    auto start = chrono::steady_clock::now();
+    string line;
+    while (getline(in, line)) {
+        lineNumber++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        vector<string> f = splitFields(line);
+        const string &cmd = f[0];
+        size_t n = f.size();
+        bool ok = true;
+        bool isOperation = true;
+        OpStatus status = OP_OK;
+        vector<OpStatus> itemStatuses;
+        try {
+            lib.trimToBudget();
+            lib.expireReservations(clock.nowInMinutes());
+            long long now = clock.nowInMinutes();
+            auto userArg = [&lib](const string &s) {
+                User *user = lib.findUser(stoi(s));
+                if (!user) throw invalid_argument("unknown user");
+                return user;
+            };
+            if (cmd == "advance" && n == 2) {
+                clock.advance(stoll(f[1]));
+                isOperation = false;
+            } else if (cmd == "time" && n == 2) {
+                clock.set(stoll(f[1]));
+                isOperation = false;
+            } else if (cmd == "borrow" && n == 3) {
+                status = lib.borrowBook(userArg(f[1]), stoi(f[2]), now);
+            } else if (cmd == "borrowisbn" && n == 3) {
+                int bookId;
+                status = lib.borrowBookByIsbn(userArg(f[1]), f[2], now, bookId);
+            } else if (cmd == "return" && n == 3) {
+                status = lib.returnBook(userArg(f[1]), stoi(f[2]), now).status;
+            } else if (cmd == "renew" && n == 3) {
+                status = lib.renewBook(userArg(f[1]), stoi(f[2]), now);
+            } else if (cmd == "reserve" && n == 3) {
+                status = lib.reserveBook(userArg(f[1]), stoi(f[2]), now);
+            } else if (cmd == "collect" && n == 3) {
+                status = lib.borrowReservedBook(userArg(f[1]), stoi(f[2]), now);
+            } else if (cmd == "cancel" && n == 3) {
+                status = lib.cancelReservation(userArg(f[1]), stoi(f[2]));
+            } else if (cmd == "borrowmany" && n == 3) {
+                itemStatuses = lib.borrowMany(userArg(f[1]), parseIds(f[2]), now);
+            } else if (cmd == "returnmany" && n == 2) {
+                for (const ReturnResult &r : lib.returnMany(parseLoans(f[1]), now))
+                    itemStatuses.push_back(r.status);
+            } else if (cmd == "renewmany" && n == 2) {
+                itemStatuses = lib.renewMany(parseLoans(f[1]), now);
+            } else if (cmd == "payfine" && n == 2) {
+                double paid;
+                status = lib.payFine(userArg(f[1]), paid);
+            } else if (cmd == "profile" && n == 4) {
+                userArg(f[1])->updateProfile(f[2], f[3]);
+            } else if (cmd == "addbook" && n == 6) {
+                if (lib.addBook(f[1], f[2], f[3], stoi(f[4]), f[5]) == 0)
+                    status = OP_INVALID_ISBN;
+            } else if (cmd == "updatebook" && n == 7) {
+                status = lib.updateBookDetails(stoi(f[1]), f[2], f[3], f[4], f[5].empty() ? 0 : stoi(f[5]), f[6]);
+            } else if (cmd == "import" && n == 2) {
+                if (!ifstream(f[1]).good())
+                    throw invalid_argument("cannot open feed");
+                if (quiet) lib.importCatalog(f[1]);
+                else console.importCatalog(f[1]);
+            } else if (cmd == "removebook" && n == 2) {
+                status = lib.removeBook(stoi(f[1]));
+            } else if (cmd == "adduser" && n == 5) {
+                if (!lib.addNewUser(f[1], f[2], f[3], f[4]))
+                    status = OP_INVALID_USER_TYPE;
+            } else if (cmd == "removeuser" && n == 2) {
+                status = lib.removeUser(stoi(f[1]));
+            } else {
+                isOperation = false;
+                if (cmd == "history" && n == 2) {
+                    User *user = userArg(f[1]);
+                    if (!quiet) console.displayFullBorrowHistory(user);
+                } else if (cmd == "search" && n == 2) {
+                    if (quiet) lib.searchBooks(f[1]);
+                    else console.searchBooks(f[1]);
+                } else if (cmd == "isbn" && n == 2) {
+                    if (quiet) lib.findBooksByIsbn(f[1]);
+                    else console.findByIsbn(f[1]);
+                } else if (cmd == "complete" && n == 2) {
+                    if (quiet) lib.autocomplete(f[1], 20);
+                    else console.autocomplete(f[1]);
+                } else if (cmd == "advsearch" && (n == 5 || n == 6)) {
+                    bool fuzzy = n == 6 && f[5] == "1";
+                    if (quiet) lib.advancedSearchBooks(f[1], stoi(f[2]), stoi(f[3]), stoi(f[4]), fuzzy);
+                    else console.advancedSearchBooks(f[1], stoi(f[2]), stoi(f[3]), stoi(f[4]), fuzzy);
+                } else if (cmd == "books" && n == 1) {
+                    if (!quiet) console.displayBooks();
+                } else if (cmd == "users" && n == 1) {
+                    if (!quiet) console.displayUsers();
+                } else if (cmd == "overdue" && n == 2) {
+                    int days = stoi(f[1]);
+                    if (!quiet) console.overdueReport(now, days);
+                } else if (cmd == "fines" && n == 1) {
+                    if (!quiet) console.fineAccrualReport(now);
+                } else if (cmd == "holder" && n == 2) {
+                    int bookId = stoi(f[1]);
+                    if (!quiet) console.showBorrower(bookId);
+                } else if (cmd == "check" && n == 1) {
+                    if (quiet) lib.checkConsistency();
+                    else console.consistencyReport();
+                } else if (cmd == "analytics" && n == 1) {
+                    HistoryAnalytics result;
+                    if (quiet) lib.analyzeCirculation(result);
+                    else console.circulationAnalytics();
+                } else if (cmd == "reports" && n == 1) {
+                    if (quiet) lib.getCirculationReport(10);
+                    else console.circulationReport();
+                } else if (cmd == "cachestats" && n == 1) {
+                    if (!quiet) console.searchCacheReport();
+                } else {
+                    ok = false;
+                }
+            }
+        } catch (const exception &e) {
+            ok = false;
+        }
+        if (ok) {
+            executed[cmd]++;
+            commands++;
+            if (itemStatuses.empty()) {
+                if (status != OP_OK)
+                    refused[status]++;
+                if (!quiet && isOperation)
+                    cout << "[line " << lineNumber << "] " << cmd << ": " << opStatusToString(status) << endl;
+            } else {
+                int succeeded = 0;
+                for (OpStatus itemStatus : itemStatuses) {
+                    if (itemStatus == OP_OK)
+                        succeeded++;
+                    else
+                        refused[itemStatus]++;
+                }
+                if (!quiet)
+                    cout << "[line " << lineNumber << "] " << cmd << ": " << succeeded << " of "
+                         << itemStatuses.size() << " succeeded" << endl;
+            }
+        } else {
+            rejected.push_back(to_string(lineNumber) + ": " + line);
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    cout << endl << "Batch summary for " << path << ":" << endl;
+    for (const auto &entry : executed)
+        cout << "  " << entry.first << ": " << entry.second << endl;
+    cout << "Commands executed: " << commands << " in " << seconds << " s ("
+         << static_cast<long long>(seconds > 0 ? commands / seconds : 0) << " commands/sec)" << endl;
+    if (!refused.empty()) {
+        cout << "Refused operations:" << endl;
+        for (const auto &entry : refused)
+            cout << "  " << entry.second << " x " << opStatusToString(entry.first) << endl;
+    }
+    if (!rejected.empty()) {
+        cout << "Rejected lines: " << rejected.size() << endl;
+        for (size_t i = 0; i < rejected.size() && i < 10; i++)
+            cout << "  line " << rejected[i] << endl;
+    }
+    return rejected.size();
+}
@@ -0,0 +1,26 @@
+/*
+ * BatchRunner.h
+ *
+ * This file declares the headless batch mode. A command file is executed line
+ * by line against the library without any interactive prompts, which allows
+ * circulation to be bulk-processed or benchmarked without a terminal.
+ *
+ * Each line holds one operation whose fields are separated by '|'; blank lines
+ * and lines starting with '#' are ignored. Times come from the VirtualClock
+ * passed in, which only moves when an "advance" or "time" command is read.
+ * The bulk commands (borrowmany, returnmany, renewmany) go through the
+ * Library's batch API and are logged with one write per line.
+ * See README.md for the list of commands.
+ */
+
+#ifndef BATCHRUNNER_H
+#define BATCHRUNNER_H
+
+#include "Library.h"
+#include "Clock.h"
+#include <string>
+using namespace std;
+
+int runBatch(Library &lib, VirtualClock &clock, const string &path, bool quiet);
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * BloomFilter.cpp
+ *
+ * This file implements the BloomFilter class declared in BloomFilter.h.
+ */
+
+#include "BloomFilter.h"
+using namespace std;
+
+namespace {
+
+// splitmix64 finalizer: spreads nearby keys (consecutive ISBNs) over the
+// whole 64 bits.
+uint64_t mix(uint64_t x) {
+    x += 0x9e3779b97f4a7c15ULL;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+    return x ^ (x >> 31);
+}
+
+}
+
+// About ten bits per key, rounded up to a power of two so a bit position is
+// a mask rather than a division.
+BloomFilter::BloomFilter(size_t expectedKeys) {
+    size_t bitCount = 64;
+    while (bitCount < expectedKeys * 10)
+        bitCount *= 2;
+    bits.assign(bitCount / 64, 0);
+    mask = bitCount - 1;
+}
+
+// The HASHES positions are h1 + i * h2 (double hashing), both halves of one
+// mixed value.
+void BloomFilter::add(uint64_t key) {
+    uint64_t h = mix(key);
+    uint64_t h1 = h, h2 = (h >> 32) | 1;
+    for (int i = 0; i < HASHES; i++) {
+        uint64_t bit = (h1 + i * h2) & mask;
+        bits[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+}
+
+bool BloomFilter::mayContain(uint64_t key) const {
+    uint64_t h = mix(key);
+    uint64_t h1 = h, h2 = (h >> 32) | 1;
+    for (int i = 0; i < HASHES; i++) {
+        uint64_t bit = (h1 + i * h2) & mask;
+        if (!(bits[bit / 64] & (uint64_t(1) << (bit % 64))))
+            return false;
+    }
+    return true;
+}
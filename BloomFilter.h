@@ -0,0 +1,36 @@
+/*
+ * BloomFilter.h
+ *
+ * This file declares the BloomFilter class, a compact set of 64-bit keys
+ * that can answer "definitely not present" without touching the exact index
+ * it stands in front of.
+ *
+ * Each key sets a few bits chosen by hashing it; a key whose bits are not all
+ * set was never added. A key whose bits are all set probably was (the filter
+ * is sized for about a 1% false-positive rate), so the caller confirms it
+ * against the exact index. Keys cannot be removed.
+ */
+
+#ifndef BLOOMFILTER_H
+#define BLOOMFILTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+using namespace std;
+
+class BloomFilter {
+public:
+    explicit BloomFilter(size_t expectedKeys);
+
+    void add(uint64_t key);
+    bool mayContain(uint64_t key) const;
+
+private:
+    static const int HASHES = 7;
+
+    vector<uint64_t> bits;
+    uint64_t mask;
+};
+
+#endif
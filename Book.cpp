@@ -7,6 +7,8 @@
  */
 
  #include "Book.h"
+ #include "Isbn.h"
+ #include "TextFold.h"
  #include <iostream>
  #include <algorithm>
  using namespace std;
@@ -19,15 +21,43 @@
  }
  
  Book::Book(int id, const string &t, const string &a, const string &p, int y, const string &i)
-     : bookId(id), title(t), author(a), publisher(p), year(y), isbn(i),
-       status(AVAILABLE), reservedBy(0), borrowCount(0), reserveTime(0) { }
+     : bookId(id), year(y), status(AVAILABLE), reservedBy(0), borrowCount(0), reserveTime(0) {
+     own(t, a, p, i);
+     buildKeys();
+ }
+ 
+ Book::Book(const CatalogEntry &entry)
+     : bookId(entry.bookId), title(entry.title), author(entry.author), publisher(entry.publisher),
+       year(entry.year), isbn(entry.isbn),
+       status(AVAILABLE), reservedBy(0), borrowCount(0), reserveTime(0) {
+     buildKeys();
+ }
+ 
+ // The new text is copied before the old copy is released, so the arguments
+ // may refer to this book's own fields.
+ void Book::own(const string &t, const string &a, const string &p, const string &i) {
+     ownedText.reset(new OwnedText{t, a, p, i});
+     title = ownedText->title;
+     author = ownedText->author;
+     publisher = ownedText->publisher;
+     isbn = ownedText->isbn;
+ }
+ 
+ void Book::buildKeys() {
+     searchKey = foldText(title);
+     searchKey += '\n';
+     searchKey += foldText(author);
+     isbnKey = ::isbnKey(isbn);
+ }
  
  int Book::getBookId() const { return bookId; }
- string Book::getTitle() const { return title; }
- string Book::getAuthor() const { return author; }
- string Book::getPublisher() const { return publisher; }
+ string Book::getTitle() const { return string(title); }
+ string Book::getAuthor() const { return string(author); }
+ string Book::getPublisher() const { return string(publisher); }
  int Book::getYear() const { return year; }
- string Book::getISBN() const { return isbn; }
+ string Book::getISBN() const { return string(isbn); }
+ const string &Book::getSearchKey() const { return searchKey; }
+ uint64_t Book::getIsbnKey() const { return isbnKey; }
  BookStatus Book::getStatus() const { return status; }
  void Book::setStatus(BookStatus s) { status = s; }
  
@@ -36,18 +66,17 @@
  
  void Book::updateDetails(const string &newTitle, const string &newAuthor,
                             const string &newPublisher, int newYear, const string &newISBN) {
-     title = newTitle;
-     author = newAuthor;
-     publisher = newPublisher;
+     own(newTitle, newAuthor, newPublisher, newISBN);
      year = newYear;
-     isbn = newISBN;
+     buildKeys();
  }
  
  void Book::incrementBorrowCount() { borrowCount++; }
  int Book::getBorrowCount() const { return borrowCount; }
+ void Book::setBorrowCount(int count) { borrowCount = count; }
  
- void Book::printDetails() const {
-     cout << "Book ID: " << bookId << "\n"
+ void Book::printDetails(ostream &out) const {
+     out << "Book ID: " << bookId << "\n"
           << "Title: " << title << "\n"
           << "Author: " << author << "\n"
           << "Publisher: " << publisher << "\n"
@@ -55,8 +84,8 @@
           << "ISBN: " << isbn << "\n"
           << "Status: " << statusToString(status);
      if (status == RESERVED)
-         cout << " (Reserved by user " << reservedBy << ")";
-     cout << "\nBorrowed " << borrowCount << " times." << "\n";
+         out << " (Reserved by user " << reservedBy << ")";
+     out << "\nBorrowed " << borrowCount << " times." << "\n";
  }
  
  long long Book::getReserveTime() const {
@@ -66,4 +95,21 @@
  void Book::setReserveTime(long long t) {
      reserveTime = t;
  }
+ 
+ bool Book::isSegmentBacked() const {
+     return !ownedText;
+ }
+ 
+ CatalogEntry Book::catalogEntry() const {
+     return {bookId, year, title, author, publisher, isbn};
+ }
+ 
+ // Points the text at a segment entry for this book and drops any owned copy.
+ void Book::rebase(const CatalogEntry &entry) {
+     title = entry.title;
+     author = entry.author;
+     publisher = entry.publisher;
+     isbn = entry.isbn;
+     ownedText.reset();
+ }
  
\ No newline at end of file
@@ -7,13 +7,30 @@
  * reservation was made), and the borrow count.
  *
  * It provides getters and setters for these attributes, as well as methods to update
- * book details, increment the borrow count, and print the book’s information.
+ * book details, increment the borrow count, and print the book’s information
+ * (to any output stream, so pages can be built in memory before writing).
+ *
+ * The descriptive text either points into the memory-mapped catalog segment
+ * (see CatalogSegment.h) or, for books added or edited since the segment was
+ * written, into a copy the book owns. updateDetails always switches to an
+ * owned copy; rebase points the book back into a freshly written segment.
+ *
+ * Each book also keeps its search key: the title and author folded to lower
+ * case without accents (see TextFold.h), separated by a newline. It is built
+ * when the book is created or its details change, so searches compare a
+ * folded term against it without folding the catalog on every query. The
+ * ISBN is likewise kept as a 64-bit key (see Isbn.h), 0 if it is not valid.
  */
 
  #ifndef BOOK_H
  #define BOOK_H
  
+ #include "CatalogSegment.h"
+ #include <cstdint>
+ #include <iostream>
+ #include <memory>
  #include <string>
+ #include <string_view>
  using namespace std;
  
  enum BookStatus { AVAILABLE, BORROWED, RESERVED };
@@ -23,6 +40,7 @@
  class Book {
  public:
      Book(int id, const string &t, const string &a, const string &p, int y, const string &i);
+     explicit Book(const CatalogEntry &entry);
      
      int getBookId() const;
      string getTitle() const;
@@ -30,6 +48,8 @@
      string getPublisher() const;
      int getYear() const;
      string getISBN() const;
+     const string &getSearchKey() const;
+     uint64_t getIsbnKey() const;
      BookStatus getStatus() const;
      void setStatus(BookStatus s);
      
@@ -40,19 +60,37 @@
                         const string &newPublisher, int newYear, const string &newISBN);
      void incrementBorrowCount();
      int getBorrowCount() const;
+     void setBorrowCount(int count);
      
-     void printDetails() const;
+     void printDetails(ostream &out = cout) const;
  
      long long getReserveTime() const;
      void setReserveTime(long long t);
+
+     bool isSegmentBacked() const;
+     CatalogEntry catalogEntry() const;
+     void rebase(const CatalogEntry &entry);
  
  private:
+     struct OwnedText {
+         string title;
+         string author;
+         string publisher;
+         string isbn;
+     };
+
+     void own(const string &t, const string &a, const string &p, const string &i);
+     void buildKeys();
+
      int bookId;
-     string title;
-     string author;
-     string publisher;
+     string_view title;
+     string_view author;
+     string_view publisher;
      int year;
-     string isbn;
+     string_view isbn;
+     unique_ptr<OwnedText> ownedText;
+     string searchKey;
+     uint64_t isbnKey;
      BookStatus status;
      int reservedBy;
      int borrowCount;
@@ -0,0 +1,110 @@
+/*
+ * CatalogImport.cpp
+ *
+ * This file implements the feed parser declared in CatalogImport.h.
+ */
+
+#include "CatalogImport.h"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <thread>
+using namespace std;
+
+namespace {
+
+// Parses the lines in text[begin, end), which starts at a line boundary.
+void parseChunk(const string &text, size_t begin, size_t end, vector<FeedRow> &rows, size_t &malformed) {
+    string_view fields[5];
+    while (begin < end) {
+        size_t lineEnd = text.find('\n', begin);
+        if (lineEnd == string::npos || lineEnd > end)
+            lineEnd = end;
+        string_view line(text.data() + begin, lineEnd - begin);
+        begin = lineEnd + 1;
+        if (!line.empty() && line.back() == '\r')
+            line.remove_suffix(1);
+        if (line.empty())
+            continue;
+        size_t count = 0, start = 0;
+        bool tooMany = false;
+        while (true) {
+            size_t comma = line.find(',', start);
+            if (count == 5) {
+                tooMany = true;
+                break;
+            }
+            fields[count++] = line.substr(start, comma == string_view::npos ? string_view::npos : comma - start);
+            if (comma == string_view::npos)
+                break;
+            start = comma + 1;
+        }
+        string_view year = count == 5 ? fields[3] : string_view();
+        if (tooMany || count != 5 || year.empty() || year.size() > 9 ||
+            !all_of(year.begin(), year.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            malformed++;
+            continue;
+        }
+        int yearValue = 0;
+        for (char c : year)
+            yearValue = yearValue * 10 + (c - '0');
+        rows.push_back({string(fields[0]), string(fields[1]), string(fields[2]), yearValue, string(fields[4])});
+    }
+}
+
+}
+
+bool parseCatalogFeed(const string &path, vector<FeedRow> &rows, size_t &malformed, int threads) {
+    rows.clear();
+    malformed = 0;
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in.is_open())
+        return false;
+    string text(static_cast<size_t>(in.tellg()), '\0');
+    in.seekg(0);
+    in.read(&text[0], text.size());
+    if (!in)
+        return false;
+
+    size_t first = 0;
+    if (text.compare(0, 6, "title,") == 0) {
+        first = text.find('\n');
+        first = first == string::npos ? text.size() : first + 1;
+    }
+    if (threads <= 0)
+        threads = max(1u, thread::hardware_concurrency());
+    // Small feeds are not worth the thread start-up cost.
+    const size_t minChunk = 1 << 20;
+    threads = static_cast<int>(min<size_t>(threads, max<size_t>(1, (text.size() - first) / minChunk)));
+
+    vector<size_t> bounds(threads + 1, text.size());
+    bounds[0] = first;
+    for (int t = 1; t < threads; t++) {
+        size_t at = first + (text.size() - first) * t / threads;
+        size_t newline = text.find('\n', max(at, bounds[t - 1]));
+        bounds[t] = newline == string::npos ? text.size() : newline + 1;
+    }
+    vector<vector<FeedRow>> parts(threads);
+    vector<size_t> badLines(threads, 0);
+    vector<thread> workers;
+    for (int t = 0; t < threads; t++) {
+        auto work = [&, t]() { parseChunk(text, bounds[t], bounds[t + 1], parts[t], badLines[t]); };
+        if (t == threads - 1)
+            work();
+        else
+            workers.emplace_back(work);
+    }
+    for (auto &w : workers)
+        w.join();
+
+    size_t total = 0;
+    for (const auto &part : parts)
+        total += part.size();
+    rows.reserve(total);
+    for (int t = 0; t < threads; t++) {
+        move(parts[t].begin(), parts[t].end(), back_inserter(rows));
+        malformed += badLines[t];
+    }
+    return true;
+}
@@ -0,0 +1,48 @@
+/*
+ * CatalogImport.h
+ *
+ * This file declares the parser for vendor catalog feeds and the summary of
+ * an import (see Library::importCatalog).
+ *
+ * A feed is a CSV file with one title per line:
+ *   title,author,publisher,year,ISBN
+ * An optional first line starting with "title," is taken as a header. As in
+ * books.csv, fields cannot contain commas. Lines with the wrong number of
+ * fields or a year that is not a number are counted as malformed and skipped.
+ *
+ * The whole file is read at once and split into chunks at line boundaries,
+ * one per hardware thread; each thread parses its chunk into its own rows,
+ * and the chunks are joined in file order, so the result does not depend on
+ * the number of threads.
+ */
+
+#ifndef CATALOGIMPORT_H
+#define CATALOGIMPORT_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+using namespace std;
+
+struct FeedRow {
+    string title;
+    string author;
+    string publisher;
+    int year;
+    string isbn;
+};
+
+struct ImportResult {
+    bool opened;
+    size_t rows;
+    size_t added;
+    size_t duplicates;
+    size_t invalidIsbn;
+    size_t malformed;
+    double parseSeconds;
+    double seconds;
+};
+
+bool parseCatalogFeed(const string &path, vector<FeedRow> &rows, size_t &malformed, int threads = 0);
+
+#endif
@@ -0,0 +1,194 @@
+/*
+ * CatalogSegment.cpp
+ *
+ * This file implements the catalog segment declared in CatalogSegment.h.
+ * On POSIX systems the file is mapped read-only and shared; elsewhere it is
+ * read into memory in one piece.
+ */
+
+#include "CatalogSegment.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace std;
+
+namespace {
+
+const char MAGIC[8] = {'L', 'M', 'S', 'C', 'A', 'T', '2', '\0'};
+const size_t HEADER_SIZE = 16;
+
+}
+
+CatalogSegment::CatalogSegment()
+    : data(nullptr), length(0), count(0), records(nullptr), text(nullptr) {}
+
+CatalogSegment::~CatalogSegment() {
+    close();
+}
+
+// Returns false (and leaves the segment closed) if the file is missing, not a
+// catalog segment, or too short for the records and text it claims.
+bool CatalogSegment::open(const string &path) {
+    close();
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(HEADER_SIZE)) {
+        ::close(fd);
+        return false;
+    }
+    void *mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+        return false;
+    data = static_cast<const char *>(mapped);
+    length = st.st_size;
+#else
+    ifstream in(path, ios::binary | ios::ate);
+    if (!in.is_open())
+        return false;
+    buffer.resize(static_cast<size_t>(in.tellg()));
+    in.seekg(0);
+    in.read(buffer.data(), buffer.size());
+    if (!in || buffer.size() < HEADER_SIZE) {
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    length = buffer.size();
+#endif
+    uint32_t recordCount;
+    memcpy(&recordCount, data + 8, sizeof(recordCount));
+    if (memcmp(data, MAGIC, sizeof(MAGIC)) != 0 ||
+        HEADER_SIZE + static_cast<size_t>(recordCount) * sizeof(Record) > length) {
+        close();
+        return false;
+    }
+    count = recordCount;
+    records = reinterpret_cast<const Record *>(data + HEADER_SIZE);
+    text = data + HEADER_SIZE + count * sizeof(Record);
+    if (!recordsValid()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+// Every record's text must lie inside the file and the IDs must ascend (find
+// relies on it), so a truncated or damaged segment is rejected as a whole
+// rather than read past the end of the mapping.
+bool CatalogSegment::recordsValid() const {
+    uint64_t textBytes = static_cast<uint64_t>(data + length - text);
+    for (size_t i = 0; i < count; i++) {
+        const Record &r = records[i];
+        uint64_t fieldBytes = 0;
+        for (int f = 0; f < 4; f++)
+            fieldBytes += r.lengths[f];
+        if (r.textOffset > textBytes || fieldBytes > textBytes - r.textOffset)
+            return false;
+        if (i > 0 && records[i - 1].bookId >= r.bookId)
+            return false;
+    }
+    return true;
+}
+
+void CatalogSegment::close() {
+#ifndef _WIN32
+    if (data)
+        munmap(const_cast<char *>(data), length);
+#else
+    buffer.clear();
+    buffer.shrink_to_fit();
+#endif
+    data = nullptr;
+    length = count = 0;
+    records = nullptr;
+    text = nullptr;
+}
+
+bool CatalogSegment::isOpen() const {
+    return data != nullptr;
+}
+
+// Exchanges mappings, so a new segment can be opened while books still point
+// into the old one.
+void CatalogSegment::swap(CatalogSegment &other) {
+    std::swap(data, other.data);
+    std::swap(length, other.length);
+    std::swap(count, other.count);
+    std::swap(records, other.records);
+    std::swap(text, other.text);
+    buffer.swap(other.buffer);
+}
+
+size_t CatalogSegment::size() const {
+    return count;
+}
+
+CatalogEntry CatalogSegment::entry(size_t index) const {
+    const Record &r = records[index];
+    const char *p = text + r.textOffset;
+    CatalogEntry e = {r.bookId, r.year, {}, {}, {}, {}};
+    string_view *fields[4] = {&e.title, &e.author, &e.publisher, &e.isbn};
+    for (int f = 0; f < 4; f++) {
+        *fields[f] = string_view(p, r.lengths[f]);
+        p += r.lengths[f];
+    }
+    return e;
+}
+
+bool CatalogSegment::find(int bookId, CatalogEntry &entry) const {
+    const Record *end = records + count;
+    const Record *it = lower_bound(records, end, bookId, [](const Record &r, int id) {
+        return r.bookId < id;
+    });
+    if (it == end || it->bookId != bookId)
+        return false;
+    entry = this->entry(it - records);
+    return true;
+}
+
+// Entries must be sorted by ID. Returns false, writing nothing, if a field is
+// 4 GiB or longer.
+bool CatalogSegment::write(const string &path, const vector<CatalogEntry> &entries) {
+    for (const auto &e : entries) {
+        for (const string_view *field : {&e.title, &e.author, &e.publisher, &e.isbn})
+            if (field->size() > UINT32_MAX)
+                return false;
+    }
+    string tmpPath = path + ".tmp";
+    ofstream out(tmpPath, ios::binary | ios::trunc);
+    if (!out.is_open())
+        return false;
+    uint32_t recordCount = static_cast<uint32_t>(entries.size()), reserved = 0;
+    out.write(MAGIC, sizeof(MAGIC));
+    out.write(reinterpret_cast<const char *>(&recordCount), sizeof(recordCount));
+    out.write(reinterpret_cast<const char *>(&reserved), sizeof(reserved));
+    uint64_t offset = 0;
+    for (const auto &e : entries) {
+        Record r = {e.bookId, e.year, offset, {}};
+        const string_view *fields[4] = {&e.title, &e.author, &e.publisher, &e.isbn};
+        for (int f = 0; f < 4; f++) {
+            r.lengths[f] = static_cast<uint32_t>(fields[f]->size());
+            offset += r.lengths[f];
+        }
+        out.write(reinterpret_cast<const char *>(&r), sizeof(r));
+    }
+    for (const auto &e : entries) {
+        for (const string_view *field : {&e.title, &e.author, &e.publisher, &e.isbn})
+            out.write(field->data(), field->size());
+    }
+    out.close();
+    if (!out)
+        return false;
+    return rename(tmpPath.c_str(), path.c_str()) == 0;
+}
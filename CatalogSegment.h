@@ -0,0 +1,85 @@
+/*
+ * CatalogSegment.h
+ *
+ * This file declares the CatalogSegment class, a read-only file holding the
+ * descriptive fields of the catalog (title, author, publisher, year, ISBN)
+ * that is memory-mapped at startup instead of being parsed into strings.
+ *
+ * Books whose text matches the segment point straight into the mapping, so
+ * loading them allocates nothing for their text and the pages are shared by
+ * every process that maps the same file. Books added or edited since the
+ * segment was written keep their own copy of the text (the overlay) until
+ * the next merge, when saveData writes a new segment covering the whole
+ * catalog and every book is pointed into it. The segment is then the only
+ * copy of their text: books.csv keeps just their ID and mutable columns.
+ *
+ * File layout (integers are little-endian):
+ *   "LMSCAT2\0"  u32 recordCount  u32 reserved
+ *   recordCount records, sorted by book ID:
+ *     i32 bookId  i32 year  u64 textOffset
+ *     u32 titleLength  u32 authorLength  u32 publisherLength  u32 isbnLength
+ *   text heap: each record's four strings back to back from textOffset
+ *
+ * Segments in the older LMSCAT1 layout (16-bit lengths) are not opened; the
+ * books are then loaded from the full lines of books.csv that saves wrote
+ * before the segment held the text, and the next save writes a new one.
+ */
+
+#ifndef CATALOGSEGMENT_H
+#define CATALOGSEGMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+struct CatalogEntry {
+    int bookId;
+    int year;
+    string_view title;
+    string_view author;
+    string_view publisher;
+    string_view isbn;
+};
+
+class CatalogSegment {
+public:
+    CatalogSegment();
+    ~CatalogSegment();
+    CatalogSegment(const CatalogSegment &) = delete;
+    CatalogSegment &operator=(const CatalogSegment &) = delete;
+
+    bool open(const string &path);
+    void close();
+    bool isOpen() const;
+    void swap(CatalogSegment &other);
+
+    size_t size() const;
+    CatalogEntry entry(size_t index) const;
+    bool find(int bookId, CatalogEntry &entry) const;
+
+    static bool write(const string &path, const vector<CatalogEntry> &entries);
+
+private:
+    bool recordsValid() const;
+
+#pragma pack(push, 1)
+    struct Record {
+        int32_t bookId;
+        int32_t year;
+        uint64_t textOffset;
+        uint32_t lengths[4];
+    };
+#pragma pack(pop)
+
+    const char *data;
+    size_t length;
+    size_t count;
+    const Record *records;
+    const char *text;
+    vector<char> buffer;
+};
+
+#endif
@@ -0,0 +1,167 @@
+/*
+ * CirculationReports.cpp
+ *
+ * This file implements the CirculationReports class declared in
+ * CirculationReports.h.
+ */
+
+#include "CirculationReports.h"
+#include <algorithm>
+using namespace std;
+
+namespace {
+
+const long long MINUTES_PER_DAY = 24 * 60;
+
+// Calendar conversions for the proleptic Gregorian calendar, counting days
+// from 1970-01-01 (after Howard Hinnant's days_from_civil/civil_from_days).
+long long daysFromCivil(long long y, int m, int d) {
+    y -= m <= 2;
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yoe = y - era * 400;
+    long long doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    long long doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+void civilFromDays(long long z, long long &y, int &m) {
+    z += 719468;
+    long long era = (z >= 0 ? z : z - 146096) / 146097;
+    long long doe = z - era * 146097;
+    long long yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    long long doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    long long mp = (5 * doy + 2) / 153;
+    m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    y = yoe + era * 400 + (m <= 2);
+}
+
+long long floorDiv(long long a, long long b) {
+    return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+}
+
+CirculationReports::CirculationReports() : current{0, 0, {}}, stale(true), begin(0), end(0) {}
+
+void CirculationReports::reset(const CirculationTotals &totals) {
+    current = totals;
+}
+
+void CirculationReports::loanOpened(const string &role, int bookId, long long borrowTime) {
+    current.loansByRole[role]++;
+    countBorrow(bookId, borrowTime);
+}
+
+void CirculationReports::loanClosed(const string &role) {
+    auto it = current.loansByRole.find(role);
+    if (it != current.loansByRole.end() && --it->second <= 0)
+        current.loansByRole.erase(it);
+}
+
+// A renewed loan counts again if its new borrow time falls in the ranked
+// month and its old one did not.
+void CirculationReports::loanRenewed(int bookId, long long oldBorrowTime, long long newBorrowTime) {
+    if (stale)
+        return;
+    rollTo(newBorrowTime);
+    if (oldBorrowTime < begin || oldBorrowTime >= end)
+        countBorrow(bookId, newBorrowTime);
+}
+
+void CirculationReports::fineChanged(long long beforeCents, long long afterCents) {
+    current.fineCents += afterCents - beforeCents;
+    current.usersWithFines += (afterCents > 0) - (beforeCents > 0);
+}
+
+const CirculationTotals &CirculationReports::totals() const {
+    return current;
+}
+
+// Starts an empty ranking for the month containing currentTime.
+void CirculationReports::startMonth(long long currentTime) {
+    ranked.clear();
+    position.clear();
+    runStart.clear();
+    begin = monthStartOf(currentTime);
+    end = nextMonthStart(currentTime);
+    stale = false;
+}
+
+// Nothing has been borrowed in a month that has only just begun, so moving
+// on to it needs no rebuild.
+void CirculationReports::rollTo(long long currentTime) {
+    if (!stale && currentTime >= end)
+        startMonth(currentTime);
+}
+
+void CirculationReports::countBorrow(int bookId, long long borrowTime) {
+    if (stale || borrowTime < begin)
+        return;
+    rollTo(borrowTime);
+    auto it = position.find(bookId);
+    if (it == position.end()) {
+        ranked.push_back({bookId, 0});
+        it = position.emplace(bookId, ranked.size() - 1).first;
+        runStart.emplace(0, ranked.size() - 1);
+    }
+    size_t at = it->second;
+    int count = ranked[at].second;
+    size_t first = runStart[count];
+    swap(ranked[at], ranked[first]);
+    position[ranked[at].first] = at;
+    position[bookId] = first;
+    if (first + 1 < ranked.size() && ranked[first + 1].second == count)
+        runStart[count] = first + 1;
+    else
+        runStart.erase(count);
+    ranked[first].second = count + 1;
+    // If books already have the new count, their run still starts first.
+    runStart.emplace(count + 1, first);
+}
+
+void CirculationReports::invalidateMonth() {
+    stale = true;
+}
+
+bool CirculationReports::monthIsStale() const {
+    return stale;
+}
+
+long long CirculationReports::monthBegin() const {
+    return begin;
+}
+
+long long CirculationReports::monthEnd() const {
+    return end;
+}
+
+int CirculationReports::borrowsThisMonth(int bookId) const {
+    auto it = position.find(bookId);
+    return it == position.end() ? 0 : ranked[it->second].second;
+}
+
+size_t CirculationReports::booksThisMonth() const {
+    return ranked.size();
+}
+
+// The most borrowed books of the month as (book ID, borrows), highest first.
+vector<pair<int, int>> CirculationReports::topBorrowed(size_t limit) const {
+    return vector<pair<int, int>>(ranked.begin(), ranked.begin() + min(limit, ranked.size()));
+}
+
+// Times are minutes since the epoch.
+long long CirculationReports::monthStartOf(long long time) {
+    long long year;
+    int month;
+    civilFromDays(floorDiv(time, MINUTES_PER_DAY), year, month);
+    return daysFromCivil(year, month, 1) * MINUTES_PER_DAY;
+}
+
+long long CirculationReports::nextMonthStart(long long time) {
+    long long year;
+    int month;
+    civilFromDays(floorDiv(time, MINUTES_PER_DAY), year, month);
+    if (month == 12)
+        return daysFromCivil(year + 1, 1, 1) * MINUTES_PER_DAY;
+    return daysFromCivil(year, month + 1, 1) * MINUTES_PER_DAY;
+}
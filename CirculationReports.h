@@ -0,0 +1,77 @@
+/*
+ * CirculationReports.h
+ *
+ * This file declares the CirculationReports class, which keeps the figures
+ * behind the librarian's circulation report up to date as loans and fines
+ * change, so printing the report never walks every account and book:
+ * - the total of outstanding fines, and how many users owe one;
+ * - the open loans held by each role;
+ * - the books borrowed most often in the current calendar month (UTC).
+ * The Library calls the update methods from borrowing, returning, renewing,
+ * paying fines and removing users, and each costs O(1). Reserved books and
+ * waiting patrons are counted by the hold queues themselves.
+ *
+ * The monthly ranking keeps the books borrowed this month in an array sorted
+ * by count, highest first, together with the index where each count's run
+ * starts. A borrow swaps the book with the first book of its run before
+ * bumping its count, which keeps the array sorted, so the top N books are
+ * just its first N entries. As in the history records, a loan belongs to the
+ * month of its latest borrow time, so a renewal into a new month counts
+ * again. A borrow in a later month starts a new, empty ranking. Loading data
+ * or removing a book or user marks the ranking stale instead; the Library
+ * rebuilds it from the history and open loans when it is next needed.
+ */
+
+#ifndef CIRCULATIONREPORTS_H
+#define CIRCULATIONREPORTS_H
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+using namespace std;
+
+struct CirculationTotals {
+    long long fineCents;
+    int usersWithFines;
+    map<string, int> loansByRole;
+};
+
+class CirculationReports {
+public:
+    CirculationReports();
+
+    void reset(const CirculationTotals &totals);
+    void loanOpened(const string &role, int bookId, long long borrowTime);
+    void loanClosed(const string &role);
+    void loanRenewed(int bookId, long long oldBorrowTime, long long newBorrowTime);
+    void fineChanged(long long beforeCents, long long afterCents);
+    const CirculationTotals &totals() const;
+
+    void startMonth(long long currentTime);
+    void rollTo(long long currentTime);
+    void countBorrow(int bookId, long long borrowTime);
+    void invalidateMonth();
+    bool monthIsStale() const;
+    long long monthBegin() const;
+    long long monthEnd() const;
+    int borrowsThisMonth(int bookId) const;
+    size_t booksThisMonth() const;
+    vector<pair<int, int>> topBorrowed(size_t limit) const;
+
+    static long long monthStartOf(long long time);
+    static long long nextMonthStart(long long time);
+
+private:
+    CirculationTotals current;
+    bool stale;
+    long long begin;
+    long long end;
+    vector<pair<int, int>> ranked;
+    unordered_map<int, size_t> position;
+    unordered_map<int, size_t> runStart;
+};
+
+#endif
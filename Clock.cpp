@@ -0,0 +1,28 @@
+/*
+ * Clock.cpp
+ *
+ * This file implements the clocks declared in Clock.h.
+ */
+
+#include "Clock.h"
+#include "Utility.h"
+
+Clock::~Clock() {}
+
+long long SystemClock::nowInMinutes() const {
+    return getCurrentTimeInMinutes();
+}
+
+VirtualClock::VirtualClock(long long start) : current(start) {}
+
+long long VirtualClock::nowInMinutes() const {
+    return current;
+}
+
+void VirtualClock::set(long long minutes) {
+    current = minutes;
+}
+
+void VirtualClock::advance(long long minutes) {
+    current += minutes;
+}
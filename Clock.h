@@ -0,0 +1,37 @@
+/*
+ * Clock.h
+ *
+ * This file declares the clock abstraction used by the Library to read the
+ * current time (in minutes since the epoch):
+ * - Clock: Abstract interface.
+ * - SystemClock: Reads the wall clock through getCurrentTimeInMinutes().
+ * - VirtualClock: A manually driven clock used for deterministic replays and
+ *   accelerated simulations.
+ */
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+class Clock {
+public:
+    virtual ~Clock();
+    virtual long long nowInMinutes() const = 0;
+};
+
+class SystemClock : public Clock {
+public:
+    virtual long long nowInMinutes() const override;
+};
+
+class VirtualClock : public Clock {
+public:
+    explicit VirtualClock(long long start);
+    virtual long long nowInMinutes() const override;
+    void set(long long minutes);
+    void advance(long long minutes);
+
+private:
+    long long current;
+};
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * DueDateIndex.cpp
+ *
+ * This file implements the DueDateIndex class declared in DueDateIndex.h.
+ * Loans are kept in an ordered set keyed on (due time, user, book), with a
+ * secondary map from (user, book) to the due time so that renewals and returns
+ * can locate their entry directly.
+ */
+
+#include "DueDateIndex.h"
+#include <climits>
+using namespace std;
+
+void DueDateIndex::add(int userId, int bookId, long long dueTime) {
+    remove(userId, bookId);
+    entries.insert({dueTime, userId, bookId});
+    dueByLoan[{userId, bookId}] = dueTime;
+}
+
+void DueDateIndex::update(int userId, int bookId, long long dueTime) {
+    add(userId, bookId, dueTime);
+}
+
+void DueDateIndex::remove(int userId, int bookId) {
+    auto it = dueByLoan.find({userId, bookId});
+    if (it == dueByLoan.end()) return;
+    entries.erase({it->second, userId, bookId});
+    dueByLoan.erase(it);
+}
+
+void DueDateIndex::clear() {
+    entries.clear();
+    dueByLoan.clear();
+}
+
+// Loans whose due time is before the given time. A loan returned exactly at
+// its due time is not fined, so it is not overdue yet either.
+vector<DueEntry> DueDateIndex::overdueAsOf(long long time) const {
+    vector<DueEntry> result;
+    auto end = entries.lower_bound({time, INT_MIN, INT_MIN});
+    for (auto it = entries.begin(); it != end; ++it)
+        result.push_back(*it);
+    return result;
+}
+
+// Loans falling due in the window [from, to], so that with from set to the
+// current time it picks up where overdueAsOf leaves off.
+vector<DueEntry> DueDateIndex::dueBetween(long long from, long long to) const {
+    vector<DueEntry> result;
+    auto it = entries.lower_bound({from, INT_MIN, INT_MIN});
+    auto end = entries.upper_bound({to, INT_MAX, INT_MAX});
+    for (; it != end; ++it)
+        result.push_back(*it);
+    return result;
+}
+
+int DueDateIndex::size() const {
+    return entries.size();
+}
@@ -0,0 +1,49 @@
+/*
+ * DueDateIndex.h
+ *
+ * This file declares the DueDateIndex class, a library-wide index of open loans
+ * ordered by due date (borrow time plus the borrower's loan period).
+ *
+ * The Library keeps the index up to date on every borrow, renewal and return,
+ * which allows librarians to list every overdue item, or every item falling due
+ * within a window, in O(k log n) without scanning each user's account.
+ */
+
+#ifndef DUEDATEINDEX_H
+#define DUEDATEINDEX_H
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+using namespace std;
+
+struct DueEntry {
+    long long dueTime;
+    int userId;
+    int bookId;
+
+    bool operator<(const DueEntry &other) const {
+        if (dueTime != other.dueTime) return dueTime < other.dueTime;
+        if (userId != other.userId) return userId < other.userId;
+        return bookId < other.bookId;
+    }
+};
+
+class DueDateIndex {
+public:
+    void add(int userId, int bookId, long long dueTime);
+    void update(int userId, int bookId, long long dueTime);
+    void remove(int userId, int bookId);
+    void clear();
+
+    vector<DueEntry> overdueAsOf(long long time) const;
+    vector<DueEntry> dueBetween(long long from, long long to) const;
+    int size() const;
+
+private:
+    set<DueEntry> entries;
+    map<pair<int, int>, long long> dueByLoan;
+};
+
+#endif
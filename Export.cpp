@@ -0,0 +1,378 @@
+/*
+ * Export.cpp
+ *
+ * This file implements the JSON Lines and columnar exporters declared in
+ * Export.h. Each table is described once as a row visitor over the Library;
+ * the JSON exporter walks it once, and the columnar exporter walks it once
+ * per column (twice for string columns: once to build the dictionary and
+ * once to write the codes), so no table is ever copied out in full.
+ */
+
+#include "Export.h"
+#include "Isbn.h"
+#include "Utility.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+namespace {
+
+const size_t BUFFER_SIZE = 1 << 16;
+const long long MINUTES_PER_DAY = 24 * 60;
+
+// Collects output in a fixed-size buffer and hands it to the stream in large
+// writes.
+class BufferedWriter {
+public:
+    explicit BufferedWriter(ostream &out) : out(out) { buf.reserve(BUFFER_SIZE); }
+    ~BufferedWriter() { flush(); }
+
+    void put(const char *data, size_t n) {
+        if (buf.size() + n > BUFFER_SIZE)
+            flush();
+        buf.append(data, n);
+    }
+    void put(const string &s) { put(s.data(), s.size()); }
+    template <typename T>
+    void putRaw(T value) { put(reinterpret_cast<const char *>(&value), sizeof(T)); }
+    void putString(const string &s) {
+        putRaw<uint32_t>(static_cast<uint32_t>(s.size()));
+        put(s);
+    }
+    void flush() {
+        out.write(buf.data(), buf.size());
+        buf.clear();
+    }
+
+private:
+    ostream &out;
+    string buf;
+};
+
+// Builds one JSON object per line, reusing the same string for every row.
+class JsonLine {
+public:
+    void begin() { line.assign(1, '{'); }
+    void field(const char *name, long long value) {
+        key(name);
+        line += to_string(value);
+    }
+    void field(const char *name, int value) { field(name, static_cast<long long>(value)); }
+    void field(const char *name, double value) {
+        key(name);
+        char num[32];
+        snprintf(num, sizeof(num), "%.2f", value);
+        line += num;
+    }
+    void field(const char *name, const string &value) {
+        key(name);
+        line += '"';
+        for (unsigned char c : value) {
+            if (c == '"' || c == '\\') {
+                line += '\\';
+                line += static_cast<char>(c);
+            } else if (c < 0x20) {
+                char esc[8];
+                snprintf(esc, sizeof(esc), "\\u%04x", c);
+                line += esc;
+            } else {
+                line += static_cast<char>(c);
+            }
+        }
+        line += '"';
+    }
+    const string &end() {
+        line += "}\n";
+        return line;
+    }
+
+private:
+    void key(const char *name) {
+        if (line.size() > 1)
+            line += ',';
+        line += '"';
+        line += name;
+        line += "\":";
+    }
+
+    string line;
+};
+
+// Row visitors: each calls fn once per row of its table.
+struct BookRows {
+    const Library &lib;
+    template <typename F> void operator()(F fn) const {
+        for (auto b : lib.getBooks()) fn(b);
+    }
+};
+
+struct UserRows {
+    const Library &lib;
+    template <typename F> void operator()(F fn) const {
+        lib.visitUsers([&](User *u) { fn(u); });
+    }
+};
+
+// Paged-out users never have open loans, so the resident users cover them all.
+struct LoanRows {
+    const Library &lib;
+    template <typename F> void operator()(F fn) const {
+        for (auto u : lib.getUsers())
+            for (const auto &bb : u->getAccount().getBorrowedBooks()) fn(u, bb);
+    }
+};
+
+struct HistoryRows {
+    const Library &lib;
+    template <typename F> void operator()(F fn) const {
+        const HistoryStore &store = lib.getHistoryStore();
+        lib.visitUsers([&](User *u) {
+            store.forEachRecord(u->getUserId(), [&](const BorrowHistory &h) { fn(u, h); });
+        });
+    }
+};
+
+template <typename Rows>
+uint64_t countRows(const Rows &rows) {
+    uint64_t n = 0;
+    rows([&](const auto &...) { n++; });
+    return n;
+}
+
+class ColumnarWriter {
+public:
+    explicit ColumnarWriter(BufferedWriter &w) : w(w) {}
+
+    template <typename Rows>
+    void beginTable(const string &name, const Rows &rows, uint32_t columns) {
+        w.putString(name);
+        w.putRaw<uint64_t>(countRows(rows));
+        w.putRaw<uint32_t>(columns);
+    }
+
+    template <typename Rows, typename Get>
+    void intColumn(const string &name, const Rows &rows, Get get) {
+        w.putString(name);
+        w.putRaw<char>('i');
+        rows([&](const auto &...row) { w.putRaw<int64_t>(get(row...)); });
+    }
+
+    template <typename Rows, typename Get>
+    void floatColumn(const string &name, const Rows &rows, Get get) {
+        w.putString(name);
+        w.putRaw<char>('f');
+        rows([&](const auto &...row) { w.putRaw<double>(get(row...)); });
+    }
+
+    template <typename Rows, typename Get>
+    void stringColumn(const string &name, const Rows &rows, Get get) {
+        unordered_map<string, uint32_t> codes;
+        vector<string> dictionary;
+        rows([&](const auto &...row) {
+            string value = get(row...);
+            if (codes.emplace(value, static_cast<uint32_t>(dictionary.size())).second)
+                dictionary.push_back(value);
+        });
+        w.putString(name);
+        w.putRaw<char>('s');
+        w.putRaw<uint32_t>(static_cast<uint32_t>(dictionary.size()));
+        for (const auto &s : dictionary)
+            w.putString(s);
+        rows([&](const auto &...row) { w.putRaw<uint32_t>(codes.find(get(row...))->second); });
+    }
+
+private:
+    BufferedWriter &w;
+};
+
+long long dueTimeOf(User *u, const BorrowedBook &bb) {
+    return bb.borrowTime + u->getBorrowPeriod() * MINUTES_PER_DAY;
+}
+
+bool writeJsonTable(const string &path, const function<void(BufferedWriter &, JsonLine &)> &body) {
+    ofstream file(path, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error opening " << path << endl;
+        return false;
+    }
+    {
+        BufferedWriter w(file);
+        JsonLine line;
+        body(w, line);
+    }
+    return file.good();
+}
+
+}
+
+bool exportJsonLines(const Library &lib, const string &prefix) {
+    bool ok = writeJsonTable(prefix + "books.jsonl", [&](BufferedWriter &w, JsonLine &line) {
+        BookRows{lib}([&](Book *b) {
+            line.begin();
+            line.field("id", b->getBookId());
+            line.field("title", b->getTitle());
+            line.field("author", b->getAuthor());
+            line.field("publisher", b->getPublisher());
+            line.field("year", b->getYear());
+            line.field("isbn", b->getISBN());
+            line.field("status", statusToString(b->getStatus()));
+            line.field("reservedBy", b->getReservedBy());
+            line.field("reserveTime", b->getReserveTime());
+            line.field("borrowCount", b->getBorrowCount());
+            w.put(line.end());
+        });
+    });
+    ok = ok && writeJsonTable(prefix + "users.jsonl", [&](BufferedWriter &w, JsonLine &line) {
+        UserRows{lib}([&](User *u) {
+            line.begin();
+            line.field("id", u->getUserId());
+            line.field("name", u->getName());
+            line.field("username", u->getUsername());
+            line.field("role", u->getRole());
+            line.field("fine", u->getAccount().getFine());
+            line.field("borrowed", u->getAccount().getBorrowedCount());
+            w.put(line.end());
+        });
+    });
+    ok = ok && writeJsonTable(prefix + "loans.jsonl", [&](BufferedWriter &w, JsonLine &line) {
+        LoanRows{lib}([&](User *u, const BorrowedBook &bb) {
+            line.begin();
+            line.field("userId", u->getUserId());
+            line.field("bookId", bb.bookId);
+            line.field("borrowTime", bb.borrowTime);
+            line.field("dueTime", dueTimeOf(u, bb));
+            w.put(line.end());
+        });
+    });
+    ok = ok && writeJsonTable(prefix + "history.jsonl", [&](BufferedWriter &w, JsonLine &line) {
+        HistoryRows{lib}([&](User *u, const BorrowHistory &h) {
+            line.begin();
+            line.field("userId", u->getUserId());
+            line.field("bookId", h.bookId);
+            line.field("borrowTime", h.borrowTime);
+            line.field("returnTime", h.returnTime);
+            line.field("overdueDays", h.overdueDays);
+            line.field("fineCharged", h.fineCharged);
+            w.put(line.end());
+        });
+    });
+    return ok;
+}
+
+bool exportColumnar(const Library &lib, const string &path) {
+    ofstream file(path, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error opening " << path << endl;
+        return false;
+    }
+    {
+        BufferedWriter w(file);
+        ColumnarWriter col(w);
+        w.put("LMSCOL1", 8);
+        w.putRaw<uint32_t>(4);
+
+        BookRows books{lib};
+        col.beginTable("books", books, 10);
+        col.intColumn("id", books, [](Book *b) { return b->getBookId(); });
+        col.stringColumn("title", books, [](Book *b) { return b->getTitle(); });
+        col.stringColumn("author", books, [](Book *b) { return b->getAuthor(); });
+        col.stringColumn("publisher", books, [](Book *b) { return b->getPublisher(); });
+        col.intColumn("year", books, [](Book *b) { return b->getYear(); });
+        col.stringColumn("isbn", books, [](Book *b) { return b->getISBN(); });
+        col.stringColumn("status", books, [](Book *b) { return statusToString(b->getStatus()); });
+        col.intColumn("reservedBy", books, [](Book *b) { return b->getReservedBy(); });
+        col.intColumn("reserveTime", books, [](Book *b) { return b->getReserveTime(); });
+        col.intColumn("borrowCount", books, [](Book *b) { return b->getBorrowCount(); });
+
+        UserRows users{lib};
+        col.beginTable("users", users, 6);
+        col.intColumn("id", users, [](User *u) { return u->getUserId(); });
+        col.stringColumn("name", users, [](User *u) { return u->getName(); });
+        col.stringColumn("username", users, [](User *u) { return u->getUsername(); });
+        col.stringColumn("role", users, [](User *u) { return u->getRole(); });
+        col.floatColumn("fine", users, [](User *u) { return u->getAccount().getFine(); });
+        col.intColumn("borrowed", users, [](User *u) { return u->getAccount().getBorrowedCount(); });
+
+        LoanRows loans{lib};
+        col.beginTable("loans", loans, 4);
+        col.intColumn("userId", loans, [](User *u, const BorrowedBook &) { return u->getUserId(); });
+        col.intColumn("bookId", loans, [](User *, const BorrowedBook &bb) { return bb.bookId; });
+        col.intColumn("borrowTime", loans, [](User *, const BorrowedBook &bb) { return bb.borrowTime; });
+        col.intColumn("dueTime", loans, [](User *u, const BorrowedBook &bb) { return dueTimeOf(u, bb); });
+
+        HistoryRows history{lib};
+        col.beginTable("history", history, 6);
+        col.intColumn("userId", history, [](User *u, const BorrowHistory &) { return u->getUserId(); });
+        col.intColumn("bookId", history, [](User *, const BorrowHistory &h) { return h.bookId; });
+        col.intColumn("borrowTime", history, [](User *, const BorrowHistory &h) { return h.borrowTime; });
+        col.intColumn("returnTime", history, [](User *, const BorrowHistory &h) { return h.returnTime; });
+        col.intColumn("overdueDays", history, [](User *, const BorrowHistory &h) { return h.overdueDays; });
+        col.floatColumn("fineCharged", history, [](User *, const BorrowHistory &h) { return h.fineCharged; });
+    }
+    return file.good();
+}
+
+void benchmarkExport(int userCount, int historyPerUser) {
+    cout << "Building a library with " << userCount << " users and "
+         << static_cast<long long>(userCount) * historyPerUser << " history records..." << endl;
+    TransactionLogScope quiet(false);
+    Library lib;
+    const long long start = 28000000;
+    int bookCount = max(1, userCount);
+    for (int i = 1; i <= bookCount; i++)
+        lib.addBook("Export Title " + to_string(i), "Author " + to_string(i % 500),
+                    "Export Press", 1990 + i % 35, formatIsbn(completeIsbn(978000000000ULL + i)));
+    for (int i = 1; i <= userCount; i++) {
+        User *user = new Student(i, "Student " + to_string(i), "student" + to_string(i), "pwd", true);
+        lib.addUser(user);
+        for (int k = 0; k < historyPerUser; k++) {
+            long long borrowed = start + static_cast<long long>(k) * 20 * MINUTES_PER_DAY;
+            int overdue = (i + k) % 7 == 0 ? 3 : 0;
+            lib.getHistoryStore().append(i, {1 + (i * 31 + k) % bookCount, borrowed,
+                                             borrowed + (15 + overdue) * MINUTES_PER_DAY,
+                                             overdue, overdue * 10.0});
+        }
+        lib.borrowBook(user, i, start);
+    }
+    lib.getHistoryStore().shrinkToFit();
+
+    const HistoryStore &store = lib.getHistoryStore();
+    cout << "History store: " << store.memoryBytes() / (1024.0 * 1024.0) << " MiB ("
+         << static_cast<double>(store.memoryBytes()) / max<size_t>(1, store.size())
+         << " bytes per record, " << sizeof(BorrowHistory) << " as structs)" << endl;
+    uint64_t rows = lib.getBooksCount() + lib.getUsersCount() +
+                    countRows(LoanRows{lib}) + countRows(HistoryRows{lib});
+    auto report = [&](const char *format, double seconds, long long bytes) {
+        cout << format << ": " << seconds * 1000 << " ms, " << static_cast<long long>(rows / seconds)
+             << " rows/sec, " << bytes / (1024.0 * 1024.0) << " MiB ("
+             << bytes / (1024.0 * 1024.0) / seconds << " MiB/s)" << endl;
+    };
+    auto fileSize = [](const string &path) {
+        ifstream f(path, ios::binary | ios::ate);
+        return static_cast<long long>(f.tellg());
+    };
+
+    auto t0 = chrono::steady_clock::now();
+    exportJsonLines(lib, "bench_export_");
+    double jsonSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    long long jsonBytes = 0;
+    for (const char *table : {"books", "users", "loans", "history"}) {
+        string path = string("bench_export_") + table + ".jsonl";
+        jsonBytes += fileSize(path);
+        remove(path.c_str());
+    }
+    report("JSON Lines", jsonSeconds, jsonBytes);
+
+    t0 = chrono::steady_clock::now();
+    exportColumnar(lib, "bench_export.lmscol");
+    double colSeconds = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    long long colBytes = fileSize("bench_export.lmscol");
+    remove("bench_export.lmscol");
+    report("Columnar", colSeconds, colBytes);
+}
@@ -0,0 +1,38 @@
+/*
+ * Export.h
+ *
+ * This file declares the data exporters used to hand library data to
+ * analytics tools without going through the CSV files saveData() writes.
+ * Four tables are exported: books, users, open loans and borrowing history.
+ * Password hashes are never exported.
+ *
+ * - exportJsonLines(): Writes one JSON object per line to <prefix>books.jsonl,
+ *   <prefix>users.jsonl, <prefix>loans.jsonl and <prefix>history.jsonl.
+ * - exportColumnar(): Writes all four tables to a single binary file, one
+ *   array per column, with string columns dictionary-encoded.
+ * - benchmarkExport(): Times both exporters on a synthetic library.
+ *
+ * Both exporters stream straight from the live Library through a fixed-size
+ * output buffer; the only state they build up is the string dictionaries.
+ *
+ * Columnar file layout (integers are little-endian):
+ *   "LMSCOL1\0"  u32 tableCount
+ *   per table:   str name  u64 rowCount  u32 columnCount
+ *   per column:  str name  u8 type ('i' int64, 'f' float64, 's' string)
+ *                'i'/'f': rowCount values
+ *                's':     u32 dictSize, dictSize strings, rowCount u32 codes
+ *   str:         u32 length followed by the bytes
+ */
+
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include "Library.h"
+#include <string>
+using namespace std;
+
+bool exportJsonLines(const Library &lib, const string &prefix);
+bool exportColumnar(const Library &lib, const string &path);
+void benchmarkExport(int userCount, int historyPerUser);
+
+#endif
@@ -0,0 +1,45 @@
+/*
+ * FineAccrual.h
+ *
+ * This file declares the batch fine-accrual engine. Outstanding loans are laid
+ * out as columns (one array per field) so that overdue days and projected fines
+ * for the whole library can be computed in a single pass of branch-free integer
+ * arithmetic, split across hardware threads.
+ *
+ * - LoanColumns: Columnar snapshot of all open loans.
+ * - AccrualResult: Per-loan overdue days and projected fines, plus totals.
+ * - computeAccruals(): Runs the batch computation as of a given time.
+ * - benchmarkFineAccrual(): Times the engine on a synthetic set of loans.
+ */
+
+#ifndef FINEACCRUAL_H
+#define FINEACCRUAL_H
+
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+struct LoanColumns {
+    vector<int> userIds;
+    vector<int> bookIds;
+    vector<long long> borrowTimes;
+    vector<int> periodMinutes;
+    vector<int> finePerDay;
+
+    void add(int userId, int bookId, long long borrowTime, int periodDays, int fine);
+    void clear();
+    void reserve(size_t n);
+    size_t size() const;
+};
+
+struct AccrualResult {
+    vector<int> overdueDays;
+    vector<long long> projectedFines;
+    long long totalFine;
+    size_t overdueLoans;
+};
+
+void computeAccruals(const LoanColumns &loans, long long now, AccrualResult &result, int threads = 0);
+void benchmarkFineAccrual(size_t loans);
+
+#endif
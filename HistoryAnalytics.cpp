@@ -0,0 +1,221 @@
+/*
+ * HistoryAnalytics.cpp
+ *
+ * This file implements the circulation analytics engine declared in
+ * HistoryAnalytics.h. Days are counted from the epoch in UTC, and weeks
+ * start on Monday (1970-01-01 was a Thursday).
+ */
+
+#include "HistoryAnalytics.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <thread>
+using namespace std;
+
+namespace {
+
+const long long MINUTES_PER_DAY = 24 * 60;
+
+long long dayOf(long long minutes) {
+    return minutes / MINUTES_PER_DAY - (minutes % MINUTES_PER_DAY < 0);
+}
+
+long long weekOf(long long day) {
+    return (day + 3) / 7 - ((day + 3) % 7 < 0);
+}
+
+void add(PeriodTotals &into, const PeriodTotals &from) {
+    into.borrows += from.borrows;
+    into.returns += from.returns;
+    into.loanMinutes += from.loanMinutes;
+    into.lateReturns += from.lateReturns;
+    into.fineCents += from.fineCents;
+}
+
+struct Partial {
+    vector<PeriodTotals> days;
+    vector<PeriodTotals> roles;
+    long long firstDay;
+};
+
+// The partial's totals for a day, growing its array to cover the day. The
+// span only ever widens, so a thread regrows its array a handful of times.
+PeriodTotals &dayTotals(Partial &partial, long long day) {
+    if (partial.days.empty()) {
+        partial.firstDay = day;
+        partial.days.resize(1);
+    } else if (day < partial.firstDay) {
+        partial.days.insert(partial.days.begin(), static_cast<size_t>(partial.firstDay - day), PeriodTotals());
+        partial.firstDay = day;
+    } else if (day - partial.firstDay >= static_cast<long long>(partial.days.size())) {
+        partial.days.resize(static_cast<size_t>(day - partial.firstDay + 1));
+    }
+    return partial.days[day - partial.firstDay];
+}
+
+// Rows returned before they were borrowed, which only a damaged history.csv
+// can hold, are skipped.
+void addLoan(Partial &partial, uint8_t role, long long borrowTime, long long returnTime, bool late,
+             long long fineCents) {
+    if (returnTime < borrowTime)
+        return;
+    dayTotals(partial, dayOf(borrowTime)).borrows++;
+    PeriodTotals &day = dayTotals(partial, dayOf(returnTime));
+    PeriodTotals &byRole = partial.roles[role];
+    day.returns++;
+    day.loanMinutes += returnTime - borrowTime;
+    byRole.borrows++;
+    byRole.returns++;
+    byRole.loanMinutes += returnTime - borrowTime;
+    if (late) {
+        day.lateReturns++;
+        day.fineCents += fineCents;
+        byRole.lateReturns++;
+        byRole.fineCents += fineCents;
+    }
+}
+
+void analyzeRows(const HistoryStore &history, const vector<uint8_t> &rowRoles, size_t begin, size_t end,
+                 Partial &partial) {
+    for (size_t row = begin; row < end; row++) {
+        uint8_t role = rowRoles[row];
+        if (role == NO_ROLE)
+            continue;
+        uint32_t r = static_cast<uint32_t>(row);
+        int overdueDays;
+        long long fineCents = 0;
+        bool late = history.lateAt(r, overdueDays, fineCents);
+        addLoan(partial, role, history.borrowTimeAt(r), history.returnTimeAt(r), late, fineCents);
+    }
+}
+
+// Streams the records of the disk-resident users order[begin, end) from
+// history.csv; nothing read is kept beyond one user's records.
+void analyzeDiskUsers(const HistoryStore &history, const vector<int> &order, size_t begin, size_t end,
+                      const unordered_map<int, uint8_t> &userRoles, Partial &partial) {
+    history.forEachDiskRecord(order, begin, end, [&](int userId, const BorrowHistory &h) {
+        auto it = userRoles.find(userId);
+        if (it == userRoles.end() || it->second == NO_ROLE)
+            return;
+        long long fineCents = llround(h.fineCharged * 100);
+        addLoan(partial, it->second, h.borrowTime, h.returnTime, h.overdueDays != 0 || fineCents != 0, fineCents);
+    });
+}
+
+// The t-th of threads contiguous shares of n items.
+void shareOf(size_t n, int threads, int t, size_t &begin, size_t &end) {
+    size_t chunk = (n + threads - 1) / threads;
+    begin = min(n, t * chunk);
+    end = min(n, begin + chunk);
+}
+
+}
+
+// Thread t takes the t-th share of the resident rows and of the users on
+// disk; the last share runs on the calling thread.
+void analyzeHistory(const HistoryStore &history, const vector<uint8_t> &rowRoles,
+                    const unordered_map<int, uint8_t> &userRoles, const vector<string> &roleNames,
+                    HistoryAnalytics &result, int threads) {
+    auto start = chrono::steady_clock::now();
+    size_t rows = min(history.residentSize(), rowRoles.size());
+    vector<int> diskUsers = history.diskUsersInFileOrder();
+    size_t n = rows + (history.size() - history.residentSize());
+    if (threads <= 0)
+        threads = max(1u, thread::hardware_concurrency());
+    // Small histories are not worth the thread start-up cost.
+    const size_t minChunk = 1 << 16;
+    threads = static_cast<int>(min<size_t>(threads, max<size_t>(1, n / minChunk)));
+
+    vector<Partial> partials(threads);
+    auto work = [&](int t) {
+        Partial &partial = partials[t];
+        partial.roles.assign(roleNames.size(), PeriodTotals());
+        size_t begin, end;
+        shareOf(rows, threads, t, begin, end);
+        analyzeRows(history, rowRoles, begin, end, partial);
+        shareOf(diskUsers.size(), threads, t, begin, end);
+        analyzeDiskUsers(history, diskUsers, begin, end, userRoles, partial);
+    };
+    vector<thread> workers;
+    for (int t = 0; t < threads - 1; t++)
+        workers.emplace_back(work, t);
+    work(threads - 1);
+    for (auto &w : workers)
+        w.join();
+
+    long long firstDay = LLONG_MAX, lastDay = LLONG_MIN;
+    for (const Partial &p : partials) {
+        if (p.days.empty())
+            continue;
+        firstDay = min(firstDay, p.firstDay);
+        lastDay = max(lastDay, p.firstDay + static_cast<long long>(p.days.size()) - 1);
+    }
+    size_t dayCount = firstDay <= lastDay ? static_cast<size_t>(lastDay - firstDay + 1) : 0;
+    result.threads = threads;
+    result.firstDay = dayCount > 0 ? firstDay : 0;
+    result.days.assign(dayCount, PeriodTotals());
+    result.roleNames = roleNames;
+    result.roles.assign(roleNames.size(), PeriodTotals());
+    for (const Partial &p : partials) {
+        for (size_t d = 0; d < p.days.size(); d++)
+            add(result.days[p.firstDay - firstDay + d], p.days[d]);
+        for (size_t r = 0; r < roleNames.size(); r++)
+            add(result.roles[r], p.roles[r]);
+    }
+    result.total = PeriodTotals();
+    for (const PeriodTotals &role : result.roles)
+        add(result.total, role);
+    result.records = static_cast<size_t>(result.total.returns);
+    result.firstWeek = dayCount > 0 ? weekOf(firstDay) : 0;
+    result.weeks.assign(dayCount > 0 ? weekOf(lastDay) - result.firstWeek + 1 : 0, PeriodTotals());
+    for (size_t d = 0; d < dayCount; d++)
+        add(result.weeks[weekOf(firstDay + d) - result.firstWeek], result.days[d]);
+    result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+void benchmarkHistoryAnalytics(size_t records) {
+    cout << "Generating " << records << " synthetic history records..." << endl;
+    HistoryStore history;
+    vector<uint8_t> rowRoles;
+    rowRoles.reserve(records);
+    vector<string> roleNames = {"Student", "Faculty"};
+    mt19937 rng(31);
+    const int users = 1000000;
+    long long start = 28000000;
+    for (size_t i = 0; i < records; i++) {
+        int userId = static_cast<int>(i % users) + 1;
+        bool student = userId % 4 != 0;
+        // Two years of loans, mostly returned within the loan period.
+        long long borrowTime = start + static_cast<long long>(i * (2 * 365 * MINUTES_PER_DAY) / records);
+        long long length = static_cast<long long>(rng() % ((student ? 20 : 35) * MINUTES_PER_DAY));
+        int period = student ? 15 : 30;
+        long long late = length - period * MINUTES_PER_DAY;
+        int overdueDays = late > 0 ? static_cast<int>((late + MINUTES_PER_DAY - 1) / MINUTES_PER_DAY) : 0;
+        history.append(userId, {static_cast<int>(i % 500000) + 1, borrowTime, borrowTime + length, overdueDays,
+                                student ? overdueDays * 10.0 : 0.0});
+        rowRoles.push_back(student ? 0 : 1);
+    }
+
+    int maxThreads = max(1u, thread::hardware_concurrency());
+    unordered_map<int, uint8_t> userRoles;
+    for (int threads : {1, maxThreads}) {
+        HistoryAnalytics result;
+        analyzeHistory(history, rowRoles, userRoles, roleNames, result, threads);  // warm-up
+        const int rounds = 3;
+        double seconds = 0;
+        for (int r = 0; r < rounds; r++) {
+            analyzeHistory(history, rowRoles, userRoles, roleNames, result, threads);
+            seconds += result.seconds;
+        }
+        seconds /= rounds;
+        cout << result.threads << " thread(s): " << seconds * 1000 << " ms per pass, "
+             << static_cast<long long>(records / seconds) << " records/sec, " << result.weeks.size()
+             << " weeks, " << result.total.lateReturns << " late returns, fines "
+             << result.total.fineCents / 100 << endl;
+        if (maxThreads == 1) break;
+    }
+}
@@ -0,0 +1,67 @@
+/*
+ * HistoryAnalytics.h
+ *
+ * This file declares the circulation analytics engine, which summarises
+ * every completed loan in the HistoryStore: borrows and returns per day and
+ * per week, average loan length, the share of late returns and the fines
+ * charged, overall and for each role.
+ *
+ * The history's resident rows and its users still on disk are each split
+ * into one contiguous share per hardware thread. Each thread adds its rows,
+ * and the records it streams from its slice of history.csv, into its own
+ * partial totals (per-day arrays that grow to the days seen, and per-role
+ * counters), so nothing is shared while scanning and nothing read from disk
+ * is kept. The partials are summed at the end.
+ *
+ * - PeriodTotals: Loan counts, minutes on loan, late returns and fines.
+ * - HistoryAnalytics: The totals per day, per week, per role and overall.
+ * - analyzeHistory(): Runs the analysis over the whole history.
+ * - benchmarkHistoryAnalytics(): Times the engine on synthetic history.
+ */
+
+#ifndef HISTORYANALYTICS_H
+#define HISTORYANALYTICS_H
+
+#include "HistoryStore.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+// Borrows are counted in the period the loan started; everything else in
+// the period it was returned.
+struct PeriodTotals {
+    long long borrows;
+    long long returns;
+    long long loanMinutes;
+    long long lateReturns;
+    long long fineCents;
+};
+
+struct HistoryAnalytics {
+    size_t records;
+    int threads;
+    double seconds;
+    long long firstDay;
+    vector<PeriodTotals> days;
+    long long firstWeek;
+    vector<PeriodTotals> weeks;
+    vector<string> roleNames;
+    vector<PeriodTotals> roles;
+    PeriodTotals total;
+};
+
+// Resident rows take their role from rowRoles (one per row) and records
+// still on disk take their user's from userRoles. Rows whose role is NO_ROLE
+// or whose user is missing from userRoles (removed users) are skipped, as
+// are rows returned before they were borrowed.
+const uint8_t NO_ROLE = 0xff;
+
+void analyzeHistory(const HistoryStore &history, const vector<uint8_t> &rowRoles,
+                    const unordered_map<int, uint8_t> &userRoles, const vector<string> &roleNames,
+                    HistoryAnalytics &result, int threads = 0);
+void benchmarkHistoryAnalytics(size_t records);
+
+#endif
@@ -0,0 +1,324 @@
+/*
+ * HistoryStore.cpp
+ *
+ * This file implements the columnar history store declared in HistoryStore.h.
+ * Rows are only ever appended, so the sparse late-return values are stored in
+ * row order and the late bitmap's rank gives a row's position among them.
+ */
+
+#include "HistoryStore.h"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+using namespace std;
+
+namespace {
+
+const vector<uint32_t> noRows;
+
+}
+
+HistoryStore::HistoryStore() : diskRecords(0) {}
+
+void HistoryStore::append(int userId, const BorrowHistory &record) {
+    uint32_t row = static_cast<uint32_t>(bookIds.size());
+    if (row % BLOCK == 0)
+        blockBases.push_back(record.returnTime);
+    if (row % 64 == 0) {
+        lateRank.push_back(static_cast<uint32_t>(lateDays.size()));
+        lateBits.push_back(0);
+    }
+    bookIds.push_back(record.bookId);
+    returnDeltas.push_back(static_cast<int32_t>(record.returnTime - blockBases.back()));
+    loanLengths.push_back(static_cast<int32_t>(record.returnTime - record.borrowTime));
+    long long fineCents = llround(record.fineCharged * 100);
+    if (record.overdueDays != 0 || fineCents != 0) {
+        lateBits.back() |= 1ULL << (row % 64);
+        lateDays.push_back(record.overdueDays);
+        lateFineCents.push_back(fineCents);
+    }
+    userRows[userId].push_back(row);
+}
+
+// The user's rows stay in the columns (they are no longer reachable) until the
+// store is rebuilt from a save.
+void HistoryStore::removeUser(int userId) {
+    userRows.erase(userId);
+    auto it = onDisk.find(userId);
+    if (it != onDisk.end()) {
+        diskRecords -= it->second.count;
+        onDisk.erase(it);
+    }
+}
+
+void HistoryStore::clear() {
+    bookIds.clear();
+    returnDeltas.clear();
+    loanLengths.clear();
+    blockBases.clear();
+    lateBits.clear();
+    lateRank.clear();
+    lateDays.clear();
+    lateFineCents.clear();
+    userRows.clear();
+    onDisk.clear();
+    diskRecords = 0;
+    reader.close();
+}
+
+// Appending grows the columns geometrically; after a bulk load the slack can
+// be handed back.
+void HistoryStore::shrinkToFit() {
+    bookIds.shrink_to_fit();
+    returnDeltas.shrink_to_fit();
+    loanLengths.shrink_to_fit();
+    blockBases.shrink_to_fit();
+    lateBits.shrink_to_fit();
+    lateRank.shrink_to_fit();
+    lateDays.shrink_to_fit();
+    lateFineCents.shrink_to_fit();
+    for (auto &entry : userRows)
+        entry.second.shrink_to_fit();
+}
+
+// The index starts with the size of the history file it describes, so a file
+// written by anything other than save() is detected and loaded eagerly instead.
+bool HistoryStore::attach(const string &path, const string &indexPath) {
+    ifstream index(indexPath);
+    ifstream file(path, ios::binary | ios::ate);
+    long long expectedSize;
+    if (!index.is_open() || !file.is_open() || !(index >> expectedSize) ||
+        expectedSize != static_cast<long long>(file.tellg()))
+        return false;
+    unordered_map<int, DiskRange> ranges;
+    size_t records = 0;
+    string line;
+    getline(index, line);
+    while (getline(index, line)) {
+        if (line.empty()) continue;
+        int userId;
+        DiskRange range;
+        if (sscanf(line.c_str(), "%d,%lld,%lld,%u", &userId, &range.offset, &range.bytes, &range.count) != 4)
+            return false;
+        ranges[userId] = range;
+        records += range.count;
+    }
+    clear();
+    filePath = path;
+    onDisk.swap(ranges);
+    diskRecords = records;
+    return true;
+}
+
+// Writes to temporary files and renames them over the old ones, so a failed
+// save leaves the previous history (and its index) intact. Users still on
+// disk have their lines copied over unparsed. Fines are written from their
+// paise with two fixed decimals, so any amount reads back exactly.
+bool HistoryStore::save(const string &path, const string &indexPath, const vector<int> &userIds) {
+    string tmpPath = path + ".tmp", tmpIndexPath = indexPath + ".tmp";
+    ofstream out(tmpPath, ios::binary);
+    if (!out.is_open())
+        return false;
+    ifstream old;
+    if (!onDisk.empty())
+        old.open(filePath, ios::binary);
+    unordered_map<int, DiskRange> moved;
+    ostringstream index;
+    string buf;
+    for (int userId : userIds) {
+        long long start = out.tellp();
+        uint32_t count = 0;
+        auto it = onDisk.find(userId);
+        if (it != onDisk.end()) {
+            buf.resize(it->second.bytes);
+            old.clear();
+            old.seekg(it->second.offset);
+            old.read(&buf[0], buf.size());
+            out.write(buf.data(), buf.size());
+            count += it->second.count;
+            moved[userId] = {start, it->second.bytes, it->second.count};
+        }
+        for (uint32_t row : rowsFor(userId)) {
+            int overdueDays = 0;
+            long long fineCents = 0;
+            lateAt(row, overdueDays, fineCents);
+            out << userId << "," << bookIds[row] << "," << borrowTimeAt(row) << "," << returnTimeAt(row) << ","
+                << overdueDays << "," << fineCents / 100 << "." << setw(2) << setfill('0') << fineCents % 100
+                << "\n";
+            count++;
+        }
+        if (count > 0)
+            index << userId << "," << start << "," << static_cast<long long>(out.tellp()) - start
+                  << "," << count << "\n";
+    }
+    long long total = out.tellp();
+    out.close();
+    if (!out || (old.is_open() && !old))
+        return false;
+    old.close();
+    reader.close();
+    ofstream indexFile(tmpIndexPath);
+    indexFile << total << "\n" << index.str();
+    indexFile.close();
+    if (!indexFile || rename(tmpPath.c_str(), path.c_str()) != 0 ||
+        rename(tmpIndexPath.c_str(), indexPath.c_str()) != 0)
+        return false;
+    filePath = path;
+    onDisk.swap(moved);
+    diskRecords = 0;
+    for (const auto &entry : onDisk)
+        diskRecords += entry.second.count;
+    return true;
+}
+
+// Reads a user's disk-resident records into the columns, ahead of any rows
+// appended for them since.
+void HistoryStore::load(int userId) {
+    auto it = onDisk.find(userId);
+    if (it == onDisk.end())
+        return;
+    if (!reader.is_open())
+        reader.open(filePath, ios::binary);
+    vector<BorrowHistory> records;
+    readFromDisk(reader, it->second, records);
+    diskRecords -= it->second.count;
+    onDisk.erase(it);
+    vector<uint32_t> appended;
+    appended.swap(userRows[userId]);
+    for (const auto &r : records)
+        append(userId, r);
+    vector<uint32_t> &rows = userRows[userId];
+    rows.insert(rows.end(), appended.begin(), appended.end());
+}
+
+// The users still on disk, ordered by where their records start in the file.
+vector<int> HistoryStore::diskUsersInFileOrder() const {
+    vector<int> order;
+    order.reserve(onDisk.size());
+    for (const auto &entry : onDisk)
+        order.push_back(entry.first);
+    sort(order.begin(), order.end(), [this](int a, int b) {
+        return onDisk.at(a).offset < onDisk.at(b).offset;
+    });
+    return order;
+}
+
+void HistoryStore::loadAll() {
+    for (int userId : diskUsersInFileOrder())
+        load(userId);
+}
+
+bool HistoryStore::parseLine(const string &line, int &userId, BorrowHistory &record) {
+    stringstream ss(line);
+    vector<string> tokens;
+    string token;
+    while (getline(ss, token, ',')) {
+        tokens.push_back(token);
+    }
+    if (tokens.size() < 6)
+        return false;
+    try {
+        userId = stoi(tokens[0]);
+        record.bookId = stoi(tokens[1]);
+        record.borrowTime = stoll(tokens[2]);
+        record.returnTime = stoll(tokens[3]);
+        record.overdueDays = stoi(tokens[4]);
+        record.fineCharged = stod(tokens[5]);
+    } catch (const exception &e) {
+        return false;
+    }
+    return true;
+}
+
+// Reads one user's range through an already open file. Ranges visited in
+// file order need no seek, so the stream's buffer carries over between them.
+void HistoryStore::readFromDisk(ifstream &file, const DiskRange &range, vector<BorrowHistory> &records) const {
+    string buf(range.bytes, '\0');
+    file.clear();
+    if (file.tellg() != range.offset)
+        file.seekg(range.offset);
+    file.read(&buf[0], buf.size());
+    stringstream lines(buf);
+    string line;
+    while (getline(lines, line)) {
+        int userId;
+        BorrowHistory record;
+        if (parseLine(line, userId, record))
+            records.push_back(record);
+    }
+}
+
+size_t HistoryStore::size() const {
+    return bookIds.size() + diskRecords;
+}
+
+size_t HistoryStore::residentSize() const {
+    return bookIds.size();
+}
+
+size_t HistoryStore::countFor(int userId) const {
+    auto it = onDisk.find(userId);
+    return rowsFor(userId).size() + (it == onDisk.end() ? 0 : it->second.count);
+}
+
+BorrowHistory HistoryStore::get(uint32_t row) const {
+    BorrowHistory record = {bookIds[row], borrowTimeAt(row), returnTimeAt(row), 0, 0.0};
+    long long fineCents;
+    if (lateAt(row, record.overdueDays, fineCents))
+        record.fineCharged = fineCents / 100.0;
+    return record;
+}
+
+// Whether the row was returned late; if so, sets its overdue days and fine.
+bool HistoryStore::lateAt(uint32_t row, int &overdueDays, long long &fineCents) const {
+    uint64_t word = lateBits[row / 64];
+    uint64_t bit = 1ULL << (row % 64);
+    if (!(word & bit))
+        return false;
+    size_t i = lateRank[row / 64] + bitset<64>(word & (bit - 1)).count();
+    overdueDays = lateDays[i];
+    fineCents = lateFineCents[i];
+    return true;
+}
+
+vector<BorrowHistory> HistoryStore::forUser(int userId, size_t start, size_t count) {
+    load(userId);
+    const vector<uint32_t> &rows = rowsFor(userId);
+    vector<BorrowHistory> records;
+    size_t end = min(rows.size(), start + count);
+    for (size_t i = start; i < end; i++)
+        records.push_back(get(rows[i]));
+    return records;
+}
+
+const vector<uint32_t> &HistoryStore::rowsFor(int userId) const {
+    auto it = userRows.find(userId);
+    return it == userRows.end() ? noRows : it->second;
+}
+
+size_t HistoryStore::memoryBytes() const {
+    size_t bytes = bookIds.capacity() * sizeof(int) + returnDeltas.capacity() * sizeof(int32_t) +
+                   loanLengths.capacity() * sizeof(int32_t) + blockBases.capacity() * sizeof(long long) +
+                   lateBits.capacity() * sizeof(uint64_t) + lateRank.capacity() * sizeof(uint32_t) +
+                   lateDays.capacity() * sizeof(int) +
+                   lateFineCents.capacity() * sizeof(long long);
+    for (const auto &entry : userRows)
+        bytes += sizeof(entry) + entry.second.capacity() * sizeof(uint32_t);
+    return bytes;
+}
+
+const vector<int> &HistoryStore::bookIdColumn() const {
+    return bookIds;
+}
+
+long long HistoryStore::returnTimeAt(uint32_t row) const {
+    return blockBases[row / BLOCK] + returnDeltas[row];
+}
+
+long long HistoryStore::borrowTimeAt(uint32_t row) const {
+    return returnTimeAt(row) - loanLengths[row];
+}
@@ -0,0 +1,133 @@
+/*
+ * HistoryStore.h
+ *
+ * This file declares the HistoryStore class, the library-wide, append-only
+ * record of completed loans (BorrowHistory) that replaces the per-Account
+ * history vectors.
+ *
+ * Records are stored column by column rather than as 40-byte structs:
+ * - bookIds: one int per record.
+ * - returnTime: a 32-bit delta from the first return time of its block of
+ *   BLOCK records (one 64-bit base per block).
+ * - borrowTime: a 32-bit delta back from the record's return time (the
+ *   loan length in minutes).
+ * - overdueDays and fineCharged: sparse, kept only for late returns, which
+ *   are the minority; everything else reads back as zero. A bitmap marks the
+ *   late rows, and a running count per 64-row word finds their values in O(1).
+ * Each user has a list of the rows that belong to them, in the order they
+ * were added, so a user's history can be read without scanning the store.
+ *
+ * Times are minutes since the epoch, so the 32-bit deltas cover any two
+ * times within about 4000 years of each other.
+ *
+ * History can also stay on disk. save() writes history.csv grouped by user
+ * together with an index of each user's byte range and record count; attach()
+ * reads only that index, and a user's records are read from the file the
+ * first time forUser() or load() asks for them. forEachRecord() visits a
+ * user's records without keeping disk-resident ones in memory, for one-pass
+ * readers such as the exporters, and forEachDiskRecord() visits every record
+ * still on disk in file order for whole-history scans. Both read through an
+ * open file rather than reopening it for each user. Records appended while a
+ * user is still on disk are kept after the disk records, as if they had been
+ * loaded first.
+ */
+
+#ifndef HISTORYSTORE_H
+#define HISTORYSTORE_H
+
+#include "Account.h"
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+class HistoryStore {
+public:
+    HistoryStore();
+
+    void append(int userId, const BorrowHistory &record);
+    void removeUser(int userId);
+    void clear();
+    void shrinkToFit();
+
+    bool attach(const string &path, const string &indexPath);
+    bool save(const string &path, const string &indexPath, const vector<int> &userIds);
+    void load(int userId);
+    void loadAll();
+    static bool parseLine(const string &line, int &userId, BorrowHistory &record);
+
+    size_t size() const;
+    size_t residentSize() const;
+    size_t countFor(int userId) const;
+    BorrowHistory get(uint32_t row) const;
+    vector<BorrowHistory> forUser(int userId, size_t start, size_t count);
+    size_t memoryBytes() const;
+
+    template <typename F>
+    void forEachRecord(int userId, F fn) const {
+        auto it = onDisk.find(userId);
+        if (it != onDisk.end()) {
+            if (!reader.is_open())
+                reader.open(filePath, ios::binary);
+            vector<BorrowHistory> records;
+            readFromDisk(reader, it->second, records);
+            for (const auto &r : records) fn(r);
+        }
+        for (uint32_t row : rowsFor(userId)) fn(get(row));
+    }
+
+    // Visits fn(userId, record) for the disk-resident users order[begin, end)
+    // (see diskUsersInFileOrder), through a file handle of its own, so
+    // threads can scan separate slices at once.
+    template <typename F>
+    void forEachDiskRecord(const vector<int> &order, size_t begin, size_t end, F fn) const {
+        ifstream file(filePath, ios::binary);
+        vector<BorrowHistory> records;
+        for (size_t i = begin; i < end; i++) {
+            auto it = onDisk.find(order[i]);
+            if (it == onDisk.end())
+                continue;
+            records.clear();
+            readFromDisk(file, it->second, records);
+            for (const auto &r : records) fn(order[i], r);
+        }
+    }
+    vector<int> diskUsersInFileOrder() const;
+
+    // Column access for whole-store scans.
+    const vector<int> &bookIdColumn() const;
+    long long borrowTimeAt(uint32_t row) const;
+    long long returnTimeAt(uint32_t row) const;
+    bool lateAt(uint32_t row, int &overdueDays, long long &fineCents) const;
+    const vector<uint32_t> &rowsFor(int userId) const;
+
+private:
+    static const uint32_t BLOCK = 256;
+
+    struct DiskRange {
+        long long offset;
+        long long bytes;
+        uint32_t count;
+    };
+
+    void readFromDisk(ifstream &file, const DiskRange &range, vector<BorrowHistory> &records) const;
+
+    vector<int> bookIds;
+    vector<int32_t> returnDeltas;
+    vector<int32_t> loanLengths;
+    vector<long long> blockBases;
+    vector<uint64_t> lateBits;
+    vector<uint32_t> lateRank;
+    vector<int> lateDays;
+    vector<long long> lateFineCents;
+    unordered_map<int, vector<uint32_t>> userRows;
+    string filePath;
+    unordered_map<int, DiskRange> onDisk;
+    size_t diskRecords;
+    mutable ifstream reader;
+};
+
+#endif
@@ -0,0 +1,183 @@
+/*
+ * HoldQueues.cpp
+ *
+ * This file implements the HoldQueues class declared in HoldQueues.h. Nodes
+ * are addressed by their index in the pool, with -1 as the end of a list;
+ * unused nodes form a free list threaded through the same next field.
+ */
+
+#include "HoldQueues.h"
+#include <algorithm>
+using namespace std;
+
+HoldQueues::HoldQueues() : freeList(-1), holds(0) {}
+
+// Adds a patron to the back of a book's queue. Returns false if they are
+// already in it.
+bool HoldQueues::push(int bookId, int userId, long long holdTime) {
+    if (position(bookId, userId) != 0)
+        return false;
+    int node = allocate(userId, holdTime);
+    auto it = queues.find(bookId);
+    if (it == queues.end()) {
+        queues[bookId] = {node, node, 1};
+    } else {
+        pool[it->second.tail].next = node;
+        it->second.tail = node;
+        it->second.length++;
+    }
+    heldBy[userId].push_back(bookId);
+    holds++;
+    return true;
+}
+
+bool HoldQueues::front(int bookId, Hold &hold) const {
+    auto it = queues.find(bookId);
+    if (it == queues.end())
+        return false;
+    const Node &node = pool[it->second.head];
+    hold = {node.userId, node.holdTime};
+    return true;
+}
+
+bool HoldQueues::pop(int bookId) {
+    auto it = queues.find(bookId);
+    if (it == queues.end())
+        return false;
+    int node = it->second.head;
+    forgetHolder(pool[node].userId, bookId);
+    if (--it->second.length == 0)
+        queues.erase(it);
+    else
+        it->second.head = pool[node].next;
+    release(node);
+    holds--;
+    return true;
+}
+
+// Takes a patron out of the queue wherever they are in it.
+bool HoldQueues::remove(int bookId, int userId) {
+    auto it = queues.find(bookId);
+    if (it == queues.end())
+        return false;
+    Queue &q = it->second;
+    int prev = -1;
+    for (int node = q.head; node != -1; prev = node, node = pool[node].next) {
+        if (pool[node].userId != userId)
+            continue;
+        if (prev == -1)
+            return pop(bookId);
+        pool[prev].next = pool[node].next;
+        if (q.tail == node)
+            q.tail = prev;
+        q.length--;
+        forgetHolder(userId, bookId);
+        release(node);
+        holds--;
+        return true;
+    }
+    return false;
+}
+
+// Drops a book's whole queue in one pass. Returns the number of holds removed.
+size_t HoldQueues::removeBook(int bookId) {
+    auto it = queues.find(bookId);
+    if (it == queues.end())
+        return 0;
+    size_t removed = it->second.length;
+    for (int node = it->second.head; node != -1;) {
+        int next = pool[node].next;
+        forgetHolder(pool[node].userId, bookId);
+        release(node);
+        node = next;
+    }
+    queues.erase(it);
+    holds -= removed;
+    return removed;
+}
+
+void HoldQueues::clear() {
+    pool.clear();
+    freeList = -1;
+    queues.clear();
+    heldBy.clear();
+    holds = 0;
+}
+
+// 1 for the patron at the front, 0 if they are not in the queue.
+int HoldQueues::position(int bookId, int userId) const {
+    auto it = queues.find(bookId);
+    if (it == queues.end())
+        return 0;
+    int pos = 1;
+    for (int node = it->second.head; node != -1; node = pool[node].next, pos++) {
+        if (pool[node].userId == userId)
+            return pos;
+    }
+    return 0;
+}
+
+size_t HoldQueues::length(int bookId) const {
+    auto it = queues.find(bookId);
+    return it == queues.end() ? 0 : it->second.length;
+}
+
+size_t HoldQueues::size() const {
+    return holds;
+}
+
+// Number of books with at least one hold; empty queues are not kept.
+size_t HoldQueues::bookCount() const {
+    return queues.size();
+}
+
+vector<Hold> HoldQueues::queue(int bookId) const {
+    vector<Hold> result;
+    auto it = queues.find(bookId);
+    if (it == queues.end())
+        return result;
+    for (int node = it->second.head; node != -1; node = pool[node].next)
+        result.push_back({pool[node].userId, pool[node].holdTime});
+    return result;
+}
+
+vector<int> HoldQueues::booksHeldBy(int userId) const {
+    auto it = heldBy.find(userId);
+    return it == heldBy.end() ? vector<int>() : it->second;
+}
+
+// Books with a non-empty queue, in ascending ID order.
+vector<int> HoldQueues::books() const {
+    vector<int> result;
+    result.reserve(queues.size());
+    for (const auto &entry : queues)
+        result.push_back(entry.first);
+    sort(result.begin(), result.end());
+    return result;
+}
+
+int HoldQueues::allocate(int userId, long long holdTime) {
+    if (freeList == -1) {
+        pool.push_back({userId, holdTime, -1});
+        return pool.size() - 1;
+    }
+    int node = freeList;
+    freeList = pool[node].next;
+    pool[node] = {userId, holdTime, -1};
+    return node;
+}
+
+void HoldQueues::release(int node) {
+    pool[node].next = freeList;
+    freeList = node;
+}
+
+void HoldQueues::forgetHolder(int userId, int bookId) {
+    auto it = heldBy.find(userId);
+    if (it == heldBy.end())
+        return;
+    vector<int> &bookIds = it->second;
+    bookIds.erase(find(bookIds.begin(), bookIds.end(), bookId));
+    if (bookIds.empty())
+        heldBy.erase(it);
+}
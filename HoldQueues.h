@@ -0,0 +1,72 @@
+/*
+ * HoldQueues.h
+ *
+ * This file declares the HoldQueues class, the per-book FIFO queues of
+ * patrons waiting for a book.
+ *
+ * The patron at the front of a book's queue holds its reservation (and is
+ * mirrored in Book::getReservedBy()); everyone behind them is promoted in
+ * turn when the front hold is collected, cancelled or expires. Each hold is
+ * a small node (user, time, next) taken from a shared pool and linked into
+ * its book's queue, so joining the back and leaving the front are O(1) and
+ * freed nodes are reused rather than returned to the allocator. A per-user
+ * list of the books they are waiting for lets a removed user's holds be
+ * found without scanning every queue.
+ */
+
+#ifndef HOLDQUEUES_H
+#define HOLDQUEUES_H
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+struct Hold {
+    int userId;
+    long long holdTime;
+};
+
+class HoldQueues {
+public:
+    HoldQueues();
+
+    bool push(int bookId, int userId, long long holdTime);
+    bool front(int bookId, Hold &hold) const;
+    bool pop(int bookId);
+    bool remove(int bookId, int userId);
+    size_t removeBook(int bookId);
+    void clear();
+
+    int position(int bookId, int userId) const;
+    size_t length(int bookId) const;
+    size_t size() const;
+    size_t bookCount() const;
+    vector<Hold> queue(int bookId) const;
+    vector<int> booksHeldBy(int userId) const;
+    vector<int> books() const;
+
+private:
+    struct Node {
+        int userId;
+        long long holdTime;
+        int next;
+    };
+    struct Queue {
+        int head;
+        int tail;
+        int length;
+    };
+
+    int allocate(int userId, long long holdTime);
+    void release(int node);
+    void forgetHolder(int userId, int bookId);
+
+    vector<Node> pool;
+    int freeList;
+    unordered_map<int, Queue> queues;
+    unordered_map<int, vector<int>> heldBy;
+    size_t holds;
+};
+
+#endif
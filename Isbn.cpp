@@ -0,0 +1,137 @@
+/*
+ * Isbn.cpp
+ *
+ * This file implements the ISBN helpers and the IsbnIndex class declared in
+ * Isbn.h.
+ */
+
+#include "Isbn.h"
+#include <algorithm>
+using namespace std;
+
+namespace {
+
+int isbn13CheckDigit(uint64_t first12Digits) {
+    int sum = 0;
+    for (int i = 0; i < 12; i++) {
+        int digit = first12Digits % 10;
+        first12Digits /= 10;
+        // Read from the right, so the last of the twelve digits weighs 3.
+        sum += digit * (i % 2 == 0 ? 3 : 1);
+    }
+    return (10 - sum % 10) % 10;
+}
+
+}
+
+uint64_t completeIsbn(uint64_t first12Digits) {
+    return first12Digits * 10 + isbn13CheckDigit(first12Digits);
+}
+
+uint64_t isbnKey(string_view text) {
+    char digits[13];
+    size_t count = 0;
+    for (char c : text) {
+        if (c == '-' || c == ' ')
+            continue;
+        bool isCheckX = (c == 'X' || c == 'x') && count == 9;
+        if ((c < '0' || c > '9') && !isCheckX)
+            return 0;
+        if (count == 13)
+            return 0;
+        digits[count++] = c;
+    }
+    if (count == 10) {
+        int sum = 0;
+        for (int i = 0; i < 10; i++) {
+            int digit = (digits[i] == 'X' || digits[i] == 'x') ? 10 : digits[i] - '0';
+            sum += digit * (10 - i);
+        }
+        if (sum % 11 != 0)
+            return 0;
+        uint64_t first12 = 978;
+        for (int i = 0; i < 9; i++)
+            first12 = first12 * 10 + (digits[i] - '0');
+        return completeIsbn(first12);
+    }
+    if (count != 13 || digits[9] == 'X' || digits[9] == 'x')
+        return 0;
+    uint64_t key = 0;
+    for (int i = 0; i < 13; i++)
+        key = key * 10 + (digits[i] - '0');
+    uint64_t prefix = key / 10000000000ULL;
+    if ((prefix != 978 && prefix != 979) || completeIsbn(key / 10) != key)
+        return 0;
+    return key;
+}
+
+// The 13 digits without hyphens, or an empty string for 0.
+string formatIsbn(uint64_t key) {
+    if (key == 0)
+        return "";
+    string text = to_string(key);
+    return string(13 - min<size_t>(text.size(), 13), '0') + text;
+}
+
+IsbnIndex::IsbnIndex() : filter(0), filterCapacity(0) {}
+
+// A new key goes into the filter too; once the filter holds more keys than it
+// was sized for it is rebuilt at twice the size, so growth stays amortised O(1).
+void IsbnIndex::add(uint64_t key, int bookId) {
+    if (key == 0)
+        return;
+    vector<int> &ids = copies[key];
+    if (ids.empty()) {
+        if (copies.size() > filterCapacity)
+            rebuildFilter(copies.size() * 2);
+        else
+            filter.add(key);
+    }
+    ids.push_back(bookId);
+}
+
+void IsbnIndex::remove(uint64_t key, int bookId) {
+    auto it = copies.find(key);
+    if (it == copies.end())
+        return;
+    vector<int> &ids = it->second;
+    ids.erase(std::remove(ids.begin(), ids.end(), bookId), ids.end());
+    if (ids.empty())
+        copies.erase(it);
+}
+
+const vector<int> &IsbnIndex::find(uint64_t key) const {
+    static const vector<int> none;
+    auto it = copies.find(key);
+    return it == copies.end() ? none : it->second;
+}
+
+bool IsbnIndex::contains(uint64_t key) const {
+    return filter.mayContain(key) && copies.count(key) != 0;
+}
+
+// Number of distinct ISBNs indexed.
+size_t IsbnIndex::size() const {
+    return copies.size();
+}
+
+void IsbnIndex::reserve(size_t keys) {
+    copies.reserve(keys);
+    if (keys > filterCapacity)
+        rebuildFilter(keys);
+}
+
+void IsbnIndex::clear() {
+    copies.clear();
+    filter = BloomFilter(0);
+    filterCapacity = 0;
+}
+
+// Sizes the filter for keys entries (at least 1024) and refills it from the
+// map, which also drops the keys removed since the last rebuild.
+void IsbnIndex::rebuildFilter(size_t keys) {
+    filterCapacity = max<size_t>(keys, 1024);
+    filter = BloomFilter(filterCapacity);
+    for (const auto &entry : copies)
+        filter.add(entry.first);
+}
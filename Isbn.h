@@ -0,0 +1,58 @@
+/*
+ * Isbn.h
+ *
+ * This file declares the ISBN helpers and the IsbnIndex class, which finds
+ * every copy of a title from its ISBN in O(1), for example when a barcode
+ * is scanned at the desk.
+ *
+ * isbnKey() validates an ISBN and turns it into a 64-bit key: the value of
+ * its 13 digits read as a number. ISBN-10s are converted to the equivalent
+ * ISBN-13 (978 followed by the first nine digits and a new check digit), so
+ * both forms of the same book get the same key. Hyphens and spaces are
+ * ignored; anything else, a wrong length, a wrong check digit or an ISBN-13
+ * outside the 978/979 ranges is invalid and gives 0.
+ *
+ * IsbnIndex maps a key to the IDs of the books carrying it, in the order
+ * they were added. Books without a valid ISBN are not indexed. A Bloom filter
+ * over the indexed keys, kept up to date by add(), lets contains() reject most
+ * absent keys without probing the hash map; removed keys stay in the filter
+ * until it is next rebuilt, which only costs a lookup.
+ */
+
+#ifndef ISBN_H
+#define ISBN_H
+
+#include <cstddef>
+#include "BloomFilter.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+uint64_t isbnKey(string_view text);
+string formatIsbn(uint64_t key);
+uint64_t completeIsbn(uint64_t first12Digits);
+
+class IsbnIndex {
+public:
+    IsbnIndex();
+
+    void add(uint64_t key, int bookId);
+    void remove(uint64_t key, int bookId);
+    const vector<int> &find(uint64_t key) const;
+    bool contains(uint64_t key) const;
+    size_t size() const;
+    void reserve(size_t keys);
+    void clear();
+
+private:
+    void rebuildFilter(size_t keys);
+
+    unordered_map<uint64_t, vector<int>> copies;
+    BloomFilter filter;
+    size_t filterCapacity;
+};
+
+#endif
@@ -8,19 +8,84 @@
  *
  * It also includes functions for librarian-specific operations, such as adding
  * or removing users, and now reservation expiration logic.
+ *
+ * Nothing here writes to the console: every operation reports its outcome to
+ * the caller (see Status.h), and LibraryConsole turns outcomes into messages.
  */
 
  #include "Library.h"
  #include "Utility.h"
  #include "User.h"
  #include "Book.h"
+ #include "TextFold.h"
+ #include <chrono>
  #include <iostream>
  #include <fstream>
+ #include <iomanip>
  #include <sstream>
  #include <algorithm>
+ #include <unordered_set>
  using namespace std;
  
- Library::Library() : nextBookId(1), nextUserId(1) { }
+ const long long RESERVATION_PERIOD = 7LL * 24 * 60;
+ 
+ // A hold can be collected up to and including RESERVATION_PERIOD minutes
+ // after it starts. This is the first minute it has expired, and the minute
+ // its wheel entry fires, so the desk and the wheel agree on the deadline.
+ static long long reservationDeadline(long long reserveTime) {
+     return reserveTime + RESERVATION_PERIOD + 1;
+ }
+ 
+ // A users.csv line: id,name,role,username,hashed password,fine. Returns
+ // nullptr for a malformed line or an unknown role.
+ static User *parseUserLine(const string &line) {
+     stringstream ss(line);
+     vector<string> tokens;
+     string token;
+     while (getline(ss, token, ',')) {
+         tokens.push_back(token);
+     }
+     if (tokens.size() < 6)
+         return nullptr;
+     try {
+         int userId = stoi(tokens[0]);
+         string name = tokens[1];
+         string role = tokens[2];
+         string uname = tokens[3];
+         string hashedPwd = tokens[4];
+         double fine = stod(tokens[5]);
+         User *user = nullptr;
+         if (role == "Student")
+             user = new Student(userId, name, uname, hashedPwd, true);
+         else if (role == "Faculty")
+             user = new Faculty(userId, name, uname, hashedPwd, true);
+         else if (role == "Librarian")
+             user = new Librarian(userId, name, uname, hashedPwd, true);
+         if (user)
+             user->getAccount().setFine(fine);
+         return user;
+     } catch (const exception &e) {
+         return nullptr;
+     }
+ }
+ 
+ // The fine is written with exactly two decimals, so it reads back to the
+ // same paise however large it is (the default stream precision keeps only six
+ // significant digits). The same line is used for users.csv and the pager.
+ static string formatUserLine(User *u) {
+     ostringstream out;
+     out << u->getUserId() << "," << u->getName() << ","
+         << u->getRole() << "," << u->getUsername() << ","
+         << u->getHashedPassword() << ","
+         << fixed << setprecision(2) << u->getAccount().getFine() << "\n";
+     return out.str();
+ }
+ 
+ Library::Library()
+     : nextBookId(1), nextUserId(1), clock(&systemClock), catalogVersion(0), statusVersion(0),
+       memoryBudget(0), activeUser(nullptr), pageHits(0), pageFaults(0), pageEvictions(0) {
+     reservationWheel.reset(now());
+ }
  
  Library::~Library() {
      for (auto b : books)
@@ -29,118 +94,312 @@
          delete u;
  }
  
+ // Must be called before any data is loaded or reservations are made, since the
+ // reservation wheel is restarted at the new clock's current time.
+ void Library::setClock(Clock *c) {
+     clock = c ? c : &systemClock;
+     reservationWheel.reset(now());
+ }
+ 
+ long long Library::now() const {
+     return clock->nowInMinutes();
+ }
+ 
+ // FNV-1a hash over the circulation state of every book and user, used to
+ // check that two replays of the same workload ended in the same state.
+ unsigned long long Library::stateChecksum() const {
+     unsigned long long hash = 1469598103934665603ULL;
+     auto mix = [&hash](long long value) {
+         for (int i = 0; i < 8; i++) {
+             hash ^= static_cast<unsigned long long>(value >> (8 * i)) & 0xff;
+             hash *= 1099511628211ULL;
+         }
+     };
+     for (auto b : books) {
+         mix(b->getBookId());
+         mix(b->getStatus());
+         mix(b->getReservedBy());
+         mix(b->getReserveTime());
+         mix(b->getBorrowCount());
+     }
+     for (int bookId : holds.books()) {
+         for (const Hold &h : holds.queue(bookId)) {
+             mix(h.userId);
+             mix(h.holdTime);
+         }
+     }
+     visitUsers([&](User *u) {
+         Account &account = u->getAccount();
+         mix(u->getUserId());
+         mix(account.getFineCents());
+         for (const auto &bb : account.getBorrowedBooks()) {
+             mix(bb.bookId);
+             mix(bb.borrowTime);
+         }
+         history.forEachRecord(u->getUserId(), [&](const BorrowHistory &h) {
+             mix(h.bookId);
+             mix(h.returnTime);
+             mix(h.overdueDays);
+         });
+     });
+     return hash;
+ }
+ 
  void Library::addUser(User *user) {
-     users.push_back(user);
-     cout << "Added " << user->getRole() << ": " << user->getName() << endl;
+     insertResident(user);
+     reports.fineChanged(0, user->getAccount().getFineCents());
+     if (user->getUserId() >= nextUserId)
+         nextUserId = user->getUserId() + 1;
  }
  
- int Library::getBooksCount() const { return books.size(); }
- int Library::getUsersCount() const { return users.size(); }
- 
- void Library::checkOverdueNotifications(User *user, long long currentTime) {
-     const vector<BorrowedBook> &borrows = user->getAccount().getBorrowedBooks();
-     if (borrows.empty()) return;
-     cout << "\nOverdue Notifications:" << endl;
-     bool anyNotification = false;
-     for (const auto &bb : borrows) {
-         Book *book = findBook(bb.bookId);
-         if (!book) continue;
-         int allowedPeriod = user->getBorrowPeriod();
-         long long allowedTime = static_cast<long long>(allowedPeriod) * 24 * 60;
-         long long elapsed = currentTime - bb.borrowTime;
-         if (elapsed >= allowedTime) {
-             cout << "Book \"" << book->getTitle() << "\" is OVERDUE." << endl;
-             anyNotification = true;
-         } else if (elapsed >= allowedTime * 0.8) {
-             cout << "Book \"" << book->getTitle() << "\" is nearing its due date." << endl;
-             anyNotification = true;
+ void Library::insertResident(User *user) {
+     users.insert(user->getUserId(), user);
+     touch(user);
+ }
+ 
+ // Resident and paged-out users in ID order. A paged-out user is read into a
+ // temporary object for the call, without making them resident.
+ void Library::visitUsers(const function<void(User *)> &fn) const {
+     auto it = users.begin();
+     const auto &paged = pager.index();
+     auto pit = paged.begin();
+     string line;
+     while (it != users.end() || pit != paged.end()) {
+         if (pit == paged.end() || (it != users.end() && (*it)->getUserId() < pit->first)) {
+             fn(*it++);
+             continue;
          }
+         User *user = pager.fetch(pit->first, line) ? parseUserLine(line) : nullptr;
+         if (user)
+             fn(user);
+         delete user;
+         ++pit;
      }
-     if (!anyNotification)
-         cout << "No overdue or near-due notifications." << endl;
  }
  
- void Library::renewBook(User *user, int bookId, long long currentTime) {
-     Book *book = findBook(bookId);
-     if (!book) {
-         cout << "Book not found." << endl;
+ // A budget of 0 turns paging off. Users are only paged out by trimToBudget(),
+ // never during another operation, so User pointers stay valid until then.
+ void Library::setMemoryBudget(size_t maxResidentUsers, const string &pagePath) {
+     memoryBudget = maxResidentUsers;
+     if (memoryBudget == 0 || pager.isOpen())
          return;
+     pager.open(pagePath);
+     for (auto u : users)
+         touch(u);
+ }
+ 
+ // The active (logged-in) user is never paged out.
+ void Library::setActiveUser(User *user) {
+     activeUser = user;
+ }
+ 
+ // Pages out least recently used users until the budget is met. Users with
+ // open loans stay resident, since the due-date index and fine reports need
+ // their accounts.
+ void Library::trimToBudget() {
+     if (memoryBudget == 0)
+         return;
+     size_t excess = users.size() > memoryBudget ? users.size() - memoryBudget : 0;
+     unordered_set<User *> evicted;
+     auto it = lru.end();
+     while (evicted.size() < excess && it != lru.begin()) {
+         --it;
+         User *user = *it;
+         if (user == activeUser || user->getAccount().getBorrowedCount() > 0)
+             continue;
+         if (!pager.store(user->getUserId(), user->getUsername(), formatUserLine(user)))
+             break;
+         lruPos.erase(user->getUserId());
+         it = lru.erase(it);
+         evicted.insert(user);
      }
-     if (book->getReservedBy() != 0) {
-         cout << "Book is reserved by another user. Renewal denied." << endl;
+     if (evicted.empty())
          return;
+     for (auto user : evicted) {
+         users.erase(user->getUserId());
+         delete user;
      }
-     bool success = user->getAccount().renewBorrowedBook(bookId, currentTime);
-     if (success) {
-         cout << "Book \"" << book->getTitle() << "\" renewed successfully." << endl;
-         logTransaction(user->getUserId(), "Renewed book " + to_string(bookId));
+     pageEvictions += evicted.size();
+ }
+ 
+ PagingStats Library::getPagingStats() const {
+     PagingStats stats = {pageHits, pageFaults, pageEvictions, users.size(), pager.size(), 0,
+                          pager.memoryBytes()};
+     for (auto u : users)
+         stats.residentBytes += u->memoryFootprint();
+     return stats;
+ }
+ 
+ void Library::touch(User *user) {
+     if (memoryBudget == 0)
+         return;
+     auto pos = lruPos.find(user->getUserId());
+     if (pos != lruPos.end()) {
+         lru.splice(lru.begin(), lru, pos->second);
      } else {
-         cout << "You have not borrowed this book." << endl;
+         lru.push_front(user);
+         lruPos[user->getUserId()] = lru.begin();
      }
  }
  
- void Library::cancelReservation(User *user, int bookId) {
+ User *Library::faultIn(int userId) {
+     string line;
+     if (!pager.fetch(userId, line))
+         return nullptr;
+     User *user = parseUserLine(line);
+     if (!user)
+         return nullptr;
+     pager.erase(userId, user->getUsername());
+     insertResident(user);
+     pageFaults++;
+     return user;
+ }
+ 
+ int Library::getBooksCount() const { return books.size(); }
+ int Library::getUsersCount() const { return users.size() + pager.size(); }
+ const SlotMap<Book> &Library::getBooks() const { return books; }
+ const SlotMap<User> &Library::getUsers() const { return users; }
+ const DueDateIndex &Library::getDueIndex() const { return dueIndex; }
+ const HistoryStore &Library::getHistoryStore() const { return history; }
+ HistoryStore &Library::getHistoryStore() { return history; }
+ 
+ OpStatus Library::renewBook(User *user, int bookId, long long currentTime) {
+     if (!user)
+         return OP_INVALID_USER;
      Book *book = findBook(bookId);
-     if (!book) {
-         cout << "Book not found." << endl;
+     if (!book)
+         return OP_BOOK_NOT_FOUND;
+     OpStatus status = applyRenew(user, book, currentTime);
+     if (status == OP_OK)
+         logTransaction(user->getUserId(), "Renewed book " + to_string(bookId));
+     return status;
+ }
+ 
+ OpStatus Library::cancelReservation(User *user, int bookId) {
+     if (!user)
+         return OP_INVALID_USER;
+     Book *book = findBook(bookId);
+     if (!book)
+         return OP_BOOK_NOT_FOUND;
+     int position = holds.position(bookId, user->getUserId());
+     if (position == 0)
+         return OP_NOT_RESERVED_BY_USER;
+     holds.remove(bookId, user->getUserId());
+     if (position == 1)
+         promoteNextHold(book, now());
+     logTransaction(user->getUserId(), "Cancelled reservation for book " + to_string(bookId));
+     return OP_OK;
+ }
+ 
+ // A hold only runs down while the book is waiting on the shelf; while it is
+ // out, the holder keeps their place until it comes back.
+ bool isReservationExpired(Book *book, long long currentTime) {
+     return book->getStatus() == RESERVED && currentTime >= reservationDeadline(book->getReserveTime());
+ }
+ 
+ void Library::releaseReservation(Book *book, long long currentTime) {
+     int holder = book->getReservedBy();
+     holds.pop(book->getBookId());
+     promoteNextHold(book, currentTime);
+     logTransaction(holder, "Reservation expired for book " + to_string(book->getBookId()));
+ }
+ 
+ // Called once the front hold has left the queue. The next patron takes over
+ // the reservation with a fresh collection window, or the reservation is
+ // cleared if nobody is waiting.
+ void Library::promoteNextHold(Book *book, long long currentTime) {
+     Hold next;
+     if (!holds.front(book->getBookId(), next)) {
+         book->setReservedBy(0);
+         book->setReserveTime(0);
+         if (book->getStatus() == RESERVED) {
+             book->setStatus(AVAILABLE);
+             statusVersion++;
+         }
          return;
      }
-     if (book->getReservedBy() != user->getUserId()) {
-         cout << "You did not reserve this book." << endl;
-         return;
+     book->setReservedBy(next.userId);
+     book->setReserveTime(currentTime);
+     if (book->getStatus() == AVAILABLE) {
+         book->setStatus(RESERVED);
+         statusVersion++;
      }
-     book->setReservedBy(0);
-     book->setReserveTime(0);
-     if (book->getStatus() == RESERVED)
-         book->setStatus(AVAILABLE);
-     cout << "Reservation for book \"" << book->getTitle() << "\" cancelled." << endl;
-     logTransaction(user->getUserId(), "Cancelled reservation for book " + to_string(bookId));
+     reservationWheel.schedule(book->getBookId(), reservationDeadline(currentTime));
  }
  
- bool isReservationExpired(Book *book, long long currentTime) {
-     const long long reservationPeriod = 7LL * 24 * 60; 
-     return (currentTime - book->getReserveTime()) > reservationPeriod;
- }
- 
- void Library::advancedSearchBooks() {
-     cin.ignore();
-     cout << "Enter search term (or press enter to skip): " << endl;
-     string term;
-     getline(cin, term);
-     cout << "Enter publication year to filter (or 0 to skip): " << endl;
-     int yearFilter;
-     cin >> yearFilter;
-     cout << "Filter by availability? (1: Available, 2: Borrowed, 3: Reserved, 0: skip): " << endl;
-     int availFilter;
-     cin >> availFilter;
-     cout << "Sort results (1: Popularity, 2: Recency, 0: none): " << endl;
-     int sortOption;
-     cin >> sortOption;
+ void Library::expireReservations(long long currentTime) {
+     vector<WheelEntry> due;
+     reservationWheel.advance(currentTime, due);
+     for (const auto &entry : due) {
+         Book *book = findBook(entry.bookId);
+         // Stale entries (reservation cancelled, fulfilled, renewed or restarted
+         // by a return) are skipped, as are holds on books still out.
+         if (!book || book->getReservedBy() == 0 || book->getStatus() != RESERVED ||
+             reservationDeadline(book->getReserveTime()) != entry.deadline)
+             continue;
+         releaseReservation(book, currentTime);
+     }
+ }
+ 
+ // The term must already be folded (see TextFold.h). The search key holds
+ // the title and author separated by a newline, which a term typed on one
+ // line cannot contain, so a match never spans the two.
+ static bool matchesTerm(Book *b, const string &foldedTerm) {
+     return b->getSearchKey().find(foldedTerm) != string::npos;
+ }
+ 
+ // Every book whose title or author contains the folded term, in ID order,
+ // from the search cache when the catalog has not changed since.
+ const vector<Book *> &Library::termMatches(const string &foldedTerm) {
+     string key = "t\n" + foldedTerm;
+     if (const vector<Book *> *cached = searchCache.find(key, catalogVersion, statusVersion))
+         return *cached;
      vector<Book *> results;
      for (auto b : books) {
-         bool match = true;
-         if (!term.empty()) {
-             string title = b->getTitle(), author = b->getAuthor();
-             transform(title.begin(), title.end(), title.begin(), ::tolower);
-             transform(author.begin(), author.end(), author.begin(), ::tolower);
-             string termLower = term;
-             transform(termLower.begin(), termLower.end(), termLower.begin(), ::tolower);
-             if (title.find(termLower) == string::npos && author.find(termLower) == string::npos)
-                 match = false;
-         }
+         if (matchesTerm(b, foldedTerm))
+             results.push_back(b);
+     }
+     return searchCache.store(key, move(results), catalogVersion, statusVersion, false);
+ }
+ 
+ // With fuzzy set, the term is matched word by word against the prefix
+ // index's dictionary, allowing a few typing mistakes per word, instead of as
+ // a substring of the title or author. Results are cached under the folded
+ // term and filters; they also depend on circulation when filtering by
+ // availability or sorting by popularity.
+ vector<Book *> Library::advancedSearchBooks(const string &term, int yearFilter, int availFilter, int sortOption,
+                                             bool fuzzy) {
+     string folded = foldText(term);
+     string key = string(fuzzy ? "f\n" : "a\n") + folded + "\n" + to_string(yearFilter) + "\n" +
+                  to_string(availFilter) + "\n" + to_string(sortOption);
+     bool dependsOnStatus = availFilter != 0 || sortOption == 1;
+     if (const vector<Book *> *cached = searchCache.find(key, catalogVersion, statusVersion))
+         return *cached;
+     vector<Book *> results;
+     auto passesFilters = [&](Book *b) {
          if (yearFilter != 0 && b->getYear() != yearFilter)
-             match = false;
+             return false;
          if (availFilter != 0) {
              BookStatus status = b->getStatus();
              if (availFilter == 1 && status != AVAILABLE)
-                 match = false;
+                 return false;
              if (availFilter == 2 && status != BORROWED)
-                 match = false;
+                 return false;
              if (availFilter == 3 && status != RESERVED)
-                 match = false;
+                 return false;
+         }
+         return true;
+     };
+     if (fuzzy && !term.empty()) {
+         for (auto b : prefixIndex.fuzzyMatch(term)) {
+             if (passesFilters(b))
+                 results.push_back(b);
+         }
+     } else {
+         for (auto b : books) {
+             if (matchesTerm(b, folded) && passesFilters(b))
+                 results.push_back(b);
          }
-         if (match)
-             results.push_back(b);
      }
      if (sortOption == 1) {
          sort(results.begin(), results.end(), [](Book *a, Book *b) {
@@ -151,51 +410,80 @@
              return a->getBookId() > b->getBookId();
          });
      }
-     if (results.empty()) {
-         cout << "No matching books found." << endl;
-     } else {
-         cout << "Advanced Search Results:" << endl;
-         for (auto b : results) {
-             b->printDetails();
-             cout << "---------------------" << endl;
-         }
+     return searchCache.store(key, move(results), catalogVersion, statusVersion, dependsOnStatus);
+ }
+ 
+ // Splits a books.csv line on commas without copying. Like getline, a
+ // trailing empty field is dropped.
+ static void splitBookLine(const string &line, vector<string_view> &fields) {
+     fields.clear();
+     size_t start = 0;
+     while (start < line.size()) {
+         size_t comma = line.find(',', start);
+         if (comma == string::npos) comma = line.size();
+         fields.emplace_back(line.data() + start, comma - start);
+         start = comma + 1;
      }
  }
  
+ // A books.csv line is either id,title,author,publisher,year,isbn followed by
+ // the mutable columns status,reservedBy,reserveTime,borrowCount, or, for a
+ // book whose text is in catalog.seg, the id and the mutable columns alone.
+ // Compact lines point the book straight into the segment without reading
+ // or comparing any text; full lines (books the last save could not merge,
+ // or files written before the segment existed) still use the segment's
+ // copy when it matches, and their own otherwise.
  void Library::loadData() {
+     catalog.open("catalog.seg");
      ifstream bookFile("books.csv");
      if (bookFile.is_open()) {
          string line;
+         vector<string_view> tokens;
+         vector<Book *> loaded;
          int maxBookIdLocal = 0;
          while (getline(bookFile, line)) {
              line = trim(line);
              if (line.empty()) continue;
-             stringstream ss(line);
-             vector<string> tokens;
-             string token;
-             while (getline(ss, token, ',')) {
-                 tokens.push_back(token);
-             }
-             if (tokens.size() < 8) {
+             splitBookLine(line, tokens);
+             bool compact = tokens.size() == 5;
+             if (!compact && tokens.size() < 8) {
                  cerr << "Skipping malformed line in books.csv: " << line << endl;
                  continue;
              }
              try {
-                 int bookId = stoi(tokens[0]);
-                 string title = tokens[1];
-                 string author = tokens[2];
-                 string publisher = tokens[3];
-                 int year = stoi(tokens[4]);
-                 string isbn = tokens[5];
-                 int statusInt = stoi(tokens[6]);
-                 int reservedBy = stoi(tokens[7]);
+                 int bookId = stoi(string(tokens[0]));
+                 size_t mutableAt = compact ? 1 : 6;
+                 int statusInt = stoi(string(tokens[mutableAt]));
+                 int reservedBy = stoi(string(tokens[mutableAt + 1]));
+                 // Full lines written before reserveTime and borrowCount were
+                 // saved have only 8 or 9 columns.
+                 long long reserveTime = tokens.size() > mutableAt + 2 ? stoll(string(tokens[mutableAt + 2])) : 0;
+                 int borrowCount = tokens.size() > mutableAt + 3 ? stoi(string(tokens[mutableAt + 3])) : 0;
                  BookStatus status = static_cast<BookStatus>(statusInt);
-                 Book *book = new Book(bookId, title, author, publisher, year, isbn);
+                 CatalogEntry entry;
+                 bool inSegment = catalog.isOpen() && catalog.find(bookId, entry);
+                 Book *book;
+                 if (compact) {
+                     if (!inSegment) {
+                         cerr << "Skipping book " << bookId << " in books.csv: its details are missing from catalog.seg"
+                              << endl;
+                         continue;
+                     }
+                     book = new Book(entry);
+                 } else {
+                     int year = stoi(string(tokens[4]));
+                     if (inSegment && entry.year == year && entry.title == tokens[1] &&
+                         entry.author == tokens[2] && entry.publisher == tokens[3] && entry.isbn == tokens[5])
+                         book = new Book(entry);
+                     else
+                         book = new Book(bookId, string(tokens[1]), string(tokens[2]), string(tokens[3]),
+                                         year, string(tokens[5]));
+                 }
                  book->setStatus(status);
                  book->setReservedBy(reservedBy);
-                 // If reservedBy is non-zero, the reserveTime should have been stored.
-                 // (For simplicity, if not found, it remains 0.)
-                 books.push_back(book);
+                 book->setReserveTime(reserveTime);
+                 book->setBorrowCount(borrowCount);
+                 loaded.push_back(book);
                  if (bookId > maxBookIdLocal)
                      maxBookIdLocal = bookId;
              } catch (const exception &e) {
@@ -205,13 +493,40 @@
          }
          nextBookId = maxBookIdLocal + 1;
          bookFile.close();
+         // Sorting first means every insert is an append, even if the file was
+         // edited by hand.
+         sort(loaded.begin(), loaded.end(), [](Book *x, Book *y) {
+             return x->getBookId() < y->getBookId();
+         });
+         for (auto b : loaded) {
+             if (!books.insert(b->getBookId(), b)) {
+                 cerr << "Skipping duplicate book ID in books.csv: " << b->getBookId() << endl;
+                 delete b;
+             }
+         }
+         prefixIndex.clear();
+         prefixIndex.addAll(vector<Book *>(books.begin(), books.end()));
+         isbnIndex.clear();
+         for (auto b : books) {
+             // Kept as it is, but not reachable by ISBN until corrected.
+             if (b->getIsbnKey() == 0 && !b->getISBN().empty())
+                 cerr << "Book " << b->getBookId() << " in books.csv has an invalid ISBN: " << b->getISBN() << endl;
+             isbnIndex.add(b->getIsbnKey(), b->getBookId());
+         }
+         catalogVersion++;
+         statusVersion++;
      }
  
-     ifstream userFile("users.csv");
-     if (userFile.is_open()) {
+     // Each reservation in books.csv is the front of its book's queue; the
+     // patrons waiting behind it are in holds.csv, in queue order.
+     for (auto b : books) {
+         if (b->getReservedBy() != 0)
+             holds.push(b->getBookId(), b->getReservedBy(), b->getReserveTime());
+     }
+     ifstream holdFile("holds.csv");
+     if (holdFile.is_open()) {
          string line;
-         int maxUserIdLocal = 0;
-         while (getline(userFile, line)) {
+         while (getline(holdFile, line)) {
              line = trim(line);
              if (line.empty()) continue;
              stringstream ss(line);
@@ -220,37 +535,59 @@
              while (getline(ss, token, ',')) {
                  tokens.push_back(token);
              }
-             if (tokens.size() < 6) {
-                 cerr << "Skipping malformed line in users.csv: " << line << endl;
+             if (tokens.size() < 3) {
+                 cerr << "Skipping malformed line in holds.csv: " << line << endl;
                  continue;
              }
              try {
-                 int userId = stoi(tokens[0]);
-                 string name = tokens[1];
-                 string role = tokens[2];
-                 string uname = tokens[3];
-                 string hashedPwd = tokens[4];
-                 double fine = stod(tokens[5]);
-                 User *user = nullptr;
-                 if (role == "Student")
-                     user = new Student(userId, name, uname, hashedPwd, true);
-                 else if (role == "Faculty")
-                     user = new Faculty(userId, name, uname, hashedPwd, true);
-                 else if (role == "Librarian")
-                     user = new Librarian(userId, name, uname, hashedPwd, true);
-                 if (user) {
-                     user->getAccount().setFine(fine);
-                     users.push_back(user);
-                     if (userId > maxUserIdLocal)
-                         maxUserIdLocal = userId;
+                 int bookId = stoi(tokens[0]);
+                 int userId = stoi(tokens[1]);
+                 long long holdTime = stoll(tokens[2]);
+                 // A queue without a reservation at its front cannot be
+                 // promoted, so such lines are dropped.
+                 if (holds.length(bookId) == 0) {
+                     cerr << "Skipping hold on unreserved book in holds.csv: " << line << endl;
+                     continue;
                  }
+                 holds.push(bookId, userId, holdTime);
              } catch (const exception &e) {
+                 cerr << "Skipping malformed line in holds.csv: " << line << endl;
+                 continue;
+             }
+         }
+         holdFile.close();
+     }
+ 
+     ifstream userFile("users.csv");
+     if (userFile.is_open()) {
+         string line;
+         vector<User *> loaded;
+         int maxUserIdLocal = 0;
+         while (getline(userFile, line)) {
+             line = trim(line);
+             if (line.empty()) continue;
+             User *user = parseUserLine(line);
+             if (!user) {
                  cerr << "Skipping malformed line in users.csv: " << line << endl;
                  continue;
              }
+             loaded.push_back(user);
+             if (user->getUserId() > maxUserIdLocal)
+                 maxUserIdLocal = user->getUserId();
          }
          nextUserId = maxUserIdLocal + 1;
          userFile.close();
+         sort(loaded.begin(), loaded.end(), [](User *x, User *y) {
+             return x->getUserId() < y->getUserId();
+         });
+         for (auto u : loaded) {
+             if (!users.insert(u->getUserId(), u)) {
+                 cerr << "Skipping duplicate user ID in users.csv: " << u->getUserId() << endl;
+                 delete u;
+                 continue;
+             }
+             touch(u);
+         }
      }
  
      ifstream borrowedFile("borrowed.csv");
@@ -274,8 +611,11 @@
                  int bookId = stoi(tokens[1]);
                  long long bTime = stoll(tokens[2]);
                  User *user = findUser(userId);
-                 if (user)
+                 if (user) {
                      user->getAccount().addBorrowedBook(bookId, bTime);
+                     dueIndex.add(userId, bookId, dueTimeFor(user, bTime));
+                     loans.add(bookId, userId, bTime);
+                 }
              } catch (const exception &e) {
                  cerr << "Skipping malformed line in borrowed.csv: " << line << endl;
                  continue;
@@ -284,52 +624,56 @@
          borrowedFile.close();
      }
  
-     ifstream historyFile("history.csv");
+     // With an up-to-date history.idx, history stays on disk and each user's
+     // records are read the first time they are needed. Otherwise (first run,
+     // or history.csv edited by hand) the whole file is loaded now.
+     ifstream historyFile;
+     if (!history.attach("history.csv", "history.idx"))
+         historyFile.open("history.csv");
      if (historyFile.is_open()) {
          string line;
          while (getline(historyFile, line)) {
              line = trim(line);
              if (line.empty()) continue;
-             stringstream ss(line);
-             vector<string> tokens;
-             string token;
-             while (getline(ss, token, ',')) {
-                 tokens.push_back(token);
-             }
-             if (tokens.size() < 6) {
-                 cerr << "Skipping malformed line in history.csv: " << line << endl;
-                 continue;
-             }
-             try {
-                 int userId = stoi(tokens[0]);
-                 int bookId = stoi(tokens[1]);
-                 long long bTime = stoll(tokens[2]);
-                 long long rTime = stoll(tokens[3]);
-                 int overdueDays = stoi(tokens[4]);
-                 double fineCharged = stod(tokens[5]);
-                 User *user = findUser(userId);
-                 if (user) {
-                     BorrowHistory record = {bookId, bTime, rTime, overdueDays, fineCharged};
-                     user->getAccount().addHistoryRecord(record);
-                 }
-             } catch (const exception &e) {
+             int userId;
+             BorrowHistory record;
+             if (!HistoryStore::parseLine(line, userId, record)) {
                  cerr << "Skipping malformed line in history.csv: " << line << endl;
                  continue;
              }
+             if (findUser(userId))
+                 history.append(userId, record);
          }
          historyFile.close();
+         history.shrinkToFit();
      }
+ 
+     long long currentTime = now();
+     reservationWheel.reset(currentTime);
+     for (auto b : books) {
+         if (b->getReservedBy() != 0)
+             reservationWheel.schedule(b->getBookId(), reservationDeadline(b->getReserveTime()));
+     }
+     expireReservations(currentTime);
+     reports.reset(tallyCirculation());
+     reports.invalidateMonth();
  }
  
+ // The catalog segment is written first, so books.csv only needs the text of
+ // books it could not take in (see loadData for the two line formats).
  void Library::saveData() {
+     mergeCatalog();
      ofstream bookFile("books.csv");
      if (bookFile.is_open()) {
          for (auto b : books) {
-             bookFile << b->getBookId() << "," << b->getTitle() << ","
-                      << b->getAuthor() << "," << b->getPublisher() << ","
-                      << b->getYear() << "," << b->getISBN() << ","
-                      << static_cast<int>(b->getStatus()) << ","
-                      << b->getReservedBy() << "\n";
+             bookFile << b->getBookId() << ",";
+             if (!b->isSegmentBacked())
+                 bookFile << b->getTitle() << "," << b->getAuthor() << "," << b->getPublisher() << ","
+                          << b->getYear() << "," << b->getISBN() << ",";
+             bookFile << static_cast<int>(b->getStatus()) << ","
+                      << b->getReservedBy() << ","
+                      << b->getReserveTime() << ","
+                      << b->getBorrowCount() << "\n";
          }
          bookFile.close();
      } else {
@@ -337,12 +681,7 @@
      }
      ofstream userFile("users.csv");
      if (userFile.is_open()) {
-         for (auto u : users) {
-             userFile << u->getUserId() << "," << u->getName() << ","
-                      << u->getRole() << "," << u->getUsername() << ","
-                      << u->getHashedPassword() << ","
-                      << u->getAccount().getFine() << "\n";
-         }
+         visitUsers([&](User *u) { userFile << formatUserLine(u); });
          userFile.close();
      } else {
          cerr << "Error saving users.csv" << endl;
@@ -360,268 +699,659 @@
      } else {
          cerr << "Error saving borrowed.csv" << endl;
      }
-     ofstream historyFile("history.csv");
-     if (historyFile.is_open()) {
-         for (auto u : users) {
-             const vector<BorrowHistory> &hist = u->getAccount().getHistory();
-             for (auto h : hist) {
-                 historyFile << u->getUserId() << "," << h.bookId << ","
-                             << h.borrowTime << "," << h.returnTime << ","
-                             << h.overdueDays << "," << h.fineCharged << "\n";
-             }
+     ofstream holdFile("holds.csv");
+     if (holdFile.is_open()) {
+         for (int bookId : holds.books()) {
+             vector<Hold> queue = holds.queue(bookId);
+             // The front hold is saved with the book.
+             for (size_t i = 1; i < queue.size(); i++)
+                 holdFile << bookId << "," << queue[i].userId << "," << queue[i].holdTime << "\n";
          }
-         historyFile.close();
+         holdFile.close();
      } else {
+         cerr << "Error saving holds.csv" << endl;
+     }
+     vector<int> userIds;
+     visitUsers([&](User *u) { userIds.push_back(u->getUserId()); });
+     if (!history.save("history.csv", "history.idx", userIds))
          cerr << "Error saving history.csv" << endl;
+ }
+ 
+ // Writes a new catalog segment when the overlay is non-empty (books added
+ // or edited since the last merge) or books have been removed, then points
+ // every book into it. On failure nothing changes and the next save tries
+ // again.
+ void Library::mergeCatalog() {
+     bool stale = catalog.size() != books.size();
+     for (auto it = books.begin(); it != books.end() && !stale; ++it)
+         stale = !(*it)->isSegmentBacked();
+     if (!stale)
+         return;
+     vector<CatalogEntry> entries;
+     entries.reserve(books.size());
+     for (auto b : books)
+         entries.push_back(b->catalogEntry());
+     // The old mapping stays open until the new one is in place, since
+     // unmerged books still point into it.
+     CatalogSegment merged;
+     if (!CatalogSegment::write("catalog.seg", entries) || !merged.open("catalog.seg") ||
+         merged.size() != books.size()) {
+         cerr << "Error saving catalog.seg" << endl;
+         return;
      }
+     catalog.swap(merged);
+     size_t i = 0;
+     for (auto b : books)
+         b->rebase(catalog.entry(i++));
  }
  
- void Library::addBook(const string &title, const string &author,
-                       const string &publisher, int year, const string &isbn) {
+ // Returns the new book's ID, or 0 (adding nothing) if the ISBN is given but
+ // not valid. Several copies may share an ISBN.
+ int Library::addBook(const string &title, const string &author,
+                      const string &publisher, int year, const string &isbn) {
+     if (!isbn.empty() && isbnKey(isbn) == 0)
+         return 0;
      Book *book = new Book(nextBookId++, title, author, publisher, year, isbn);
-     books.push_back(book);
-     cout << "Added book: " << title << endl;
+     books.insert(book->getBookId(), book);
+     prefixIndex.add(book);
+     isbnIndex.add(book->getIsbnKey(), book->getBookId());
+     catalogVersion++;
      logTransaction(0, "Added book " + to_string(book->getBookId()) + ": " + title);
+     return book->getBookId();
  }
  
- void Library::removeBook(int bookId) {
-     auto it = remove_if(books.begin(), books.end(), [bookId](Book *b) {
-         return b->getBookId() == bookId;
-     });
-     if (it != books.end()) {
-         cout << "Removed book with ID: " << bookId << endl;
-         delete *it;
-         books.erase(it);
-         logTransaction(0, "Removed book " + to_string(bookId));
-     } else {
-         cout << "Book with ID " << bookId << " not found." << endl;
+ // Adds every title in a vendor feed (see CatalogImport.h) whose ISBN is not
+ // already in the catalog or earlier in the feed, as one batch with a single
+ // log record. Rows with an invalid ISBN are skipped; rows without one are
+ // added. Most rows of a feed are new, so the ISBN index's Bloom filter
+ // answers them without probing the exact index.
+ ImportResult Library::importCatalog(const string &path, int threads) {
+     ImportResult result = {false, 0, 0, 0, 0, 0, 0.0, 0.0};
+     auto start = chrono::steady_clock::now();
+     vector<FeedRow> rows;
+     if (!parseCatalogFeed(path, rows, result.malformed, threads))
+         return result;
+     result.opened = true;
+     result.rows = rows.size();
+     result.parseSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+ 
+     isbnIndex.reserve(isbnIndex.size() + rows.size());
+     vector<Book *> added;
+     for (FeedRow &row : rows) {
+         uint64_t key = 0;
+         if (!row.isbn.empty()) {
+             key = isbnKey(row.isbn);
+             if (key == 0) {
+                 result.invalidIsbn++;
+                 continue;
+             }
+             if (isbnIndex.contains(key)) {
+                 result.duplicates++;
+                 continue;
+             }
+         }
+         Book *book = new Book(nextBookId++, row.title, row.author, row.publisher, row.year, row.isbn);
+         books.insert(book->getBookId(), book);
+         isbnIndex.add(key, book->getBookId());
+         added.push_back(book);
      }
+     prefixIndex.addAll(added);
+     catalogVersion++;
+     result.added = added.size();
+     result.seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+     logTransaction(0, "Imported " + to_string(result.added) + " books from " + path + " (" +
+                           to_string(result.duplicates) + " duplicates, " +
+                           to_string(result.invalidIsbn + result.malformed) + " rejected)");
+     return result;
  }
  
- void Library::updateBookDetails(int bookId) {
-     Book *book = findBook(bookId);
-     if (!book) {
-         cout << "Book not found." << endl;
-         return;
+ // A copy that is out is written off: the loan is dropped from the borrower's
+ // account without a history record or fine.
+ OpStatus Library::removeBook(int bookId) {
+     Book *book = books.erase(bookId);
+     if (!book)
+         return OP_BOOK_NOT_FOUND;
+     if (const LoanEntry *loan = loans.find(bookId)) {
+         // Users with open loans are never paged out.
+         if (User *holder = users.find(loan->userId)) {
+             holder->getAccount().dropBorrowedBook(bookId);
+             reports.loanClosed(holder->getRole());
+         }
+         dueIndex.remove(loan->userId, bookId);
+         loans.remove(bookId);
      }
-     string newTitle, newAuthor, newPublisher, newISBN;
-     int newYear;
-     cin.ignore();
-     cout << "Enter new title (or press enter to keep \"" << book->getTitle() << "\"):" << endl;
-     getline(cin, newTitle);
-     if (newTitle.empty()) newTitle = book->getTitle();
-     cout << "Enter new author (or press enter to keep \"" << book->getAuthor() << "\"):" << endl;
-     getline(cin, newAuthor);
-     if (newAuthor.empty()) newAuthor = book->getAuthor();
-     cout << "Enter new publisher (or press enter to keep \"" << book->getPublisher() << "\"):" << endl;
-     getline(cin, newPublisher);
-     if (newPublisher.empty()) newPublisher = book->getPublisher();
-     cout << "Enter new year (or 0 to keep \"" << book->getYear() << "\"):" << endl;
-     cin >> newYear;
-     if (newYear == 0) newYear = book->getYear();
-     cin.ignore();
-     cout << "Enter new ISBN (or press enter to keep \"" << book->getISBN() << "\"):" << endl;
-     getline(cin, newISBN);
-     if (newISBN.empty()) newISBN = book->getISBN();
-     book->updateDetails(newTitle, newAuthor, newPublisher, newYear, newISBN);
-     cout << "Book details updated." << endl;
+     holds.removeBook(bookId);
+     prefixIndex.remove(book);
+     isbnIndex.remove(book->getIsbnKey(), bookId);
+     catalogVersion++;
+     // Its history stays, but a removed book is no longer ranked.
+     if (reports.borrowsThisMonth(bookId) > 0)
+         reports.invalidateMonth();
+     delete book;
+     logTransaction(0, "Removed book " + to_string(bookId));
+     return OP_OK;
+ }
+ 
+ // Empty strings (and a year of 0) keep the current value.
+ OpStatus Library::updateBookDetails(int bookId, const string &title, const string &author,
+                                     const string &publisher, int year, const string &isbn) {
+     Book *book = findBook(bookId);
+     if (!book)
+         return OP_BOOK_NOT_FOUND;
+     if (!isbn.empty() && isbnKey(isbn) == 0)
+         return OP_INVALID_ISBN;
+     prefixIndex.remove(book);
+     isbnIndex.remove(book->getIsbnKey(), bookId);
+     book->updateDetails(title.empty() ? book->getTitle() : title,
+                         author.empty() ? book->getAuthor() : author,
+                         publisher.empty() ? book->getPublisher() : publisher,
+                         year == 0 ? book->getYear() : year,
+                         isbn.empty() ? book->getISBN() : isbn);
+     prefixIndex.add(book);
+     isbnIndex.add(book->getIsbnKey(), bookId);
+     catalogVersion++;
      logTransaction(0, "Updated details for book " + to_string(bookId));
+     return OP_OK;
  }
  
- void Library::reserveBook(User *user, int bookId) {
+ OpStatus Library::reserveBook(User *user, int bookId, long long currentTime) {
+     if (!user)
+         return OP_INVALID_USER;
      Book *book = findBook(bookId);
-     if (!book) {
-         cout << "Book not found." << endl;
-         return;
+     if (!book)
+         return OP_BOOK_NOT_FOUND;
+     if (book->getStatus() == AVAILABLE)
+         return OP_BOOK_IS_AVAILABLE;
+     if (!holds.push(bookId, user->getUserId(), currentTime))
+         return OP_ALREADY_RESERVED;
+     size_t position = holds.length(bookId);
+     if (position == 1) {
+         book->setReservedBy(user->getUserId());
+         book->setReserveTime(currentTime);
+         reservationWheel.schedule(bookId, reservationDeadline(book->getReserveTime()));
+         logTransaction(user->getUserId(), "Reserved book " + to_string(bookId));
+     } else {
+         logTransaction(user->getUserId(), "Joined hold queue for book " + to_string(bookId) +
+                                               " at position " + to_string(position));
      }
-     if (book->getStatus() == AVAILABLE) {
-         cout << "Book is available. You can borrow it instead of reserving." << endl;
-         return;
+     return OP_OK;
+ }
+ 
+ OpStatus Library::borrowReservedBook(User *user, int bookId, long long currentTime) {
+     if (!user)
+         return OP_INVALID_USER;
+     Book *book = findBook(bookId);
+     if (!book)
+         return OP_BOOK_NOT_FOUND;
+     if (book->getReservedBy() == user->getUserId() && isReservationExpired(book, currentTime)) {
+         releaseReservation(book, currentTime);
+         return OP_RESERVATION_EXPIRED;
      }
-     if (book->getReservedBy() != 0) {
-         cout << "Book is already reserved." << endl;
-         return;
+     if (book->getStatus() != RESERVED || book->getReservedBy() != user->getUserId())
+         return OP_NOT_RESERVED_BY_USER;
+     OpStatus status = user->borrowBook(book, currentTime);
+     if (status == OP_OK) {
+         statusVersion++;
+         holds.pop(bookId);
+         promoteNextHold(book, currentTime);
+         dueIndex.add(user->getUserId(), bookId, dueTimeFor(user, currentTime));
+         loans.add(bookId, user->getUserId(), currentTime);
+         reports.loanOpened(user->getRole(), bookId, currentTime);
+         logTransaction(user->getUserId(), "Borrowed reserved book " + to_string(bookId));
      }
-     book->setReservedBy(user->getUserId());
-     book->setReserveTime(getCurrentTimeInMinutes());
-     cout << "Book \"" << book->getTitle() << "\" reserved successfully." << endl;
-     logTransaction(user->getUserId(), "Reserved book " + to_string(bookId));
+     return status;
  }
  
- void Library::borrowReservedBook(User *user, int bookId, long long currentTime) {
-     Book *book = findBook(bookId);
-     if (!book) {
-         cout << "Book not found." << endl;
-         return;
+ vector<Book *> Library::searchBooks(const string &term) {
+     return termMatches(foldText(term));
+ }
+ 
+ // Completes what a patron has typed so far into the most borrowed matching
+ // books; see PrefixIndex.h.
+ vector<Book *> Library::autocomplete(const string &text, int limit) const {
+     return prefixIndex.complete(text, max(0, limit));
+ }
+ 
+ // Every copy carrying the ISBN, in the order they were added; empty if the
+ // ISBN is not valid.
+ vector<Book *> Library::findBooksByIsbn(const string &isbn) const {
+     vector<Book *> copies;
+     for (int bookId : isbnIndex.find(isbnKey(isbn))) {
+         if (Book *book = books.find(bookId))
+             copies.push_back(book);
      }
-     if (isReservationExpired(book, currentTime)) {
-         book->setReservedBy(0);
-         book->setReserveTime(0);
-         book->setStatus(AVAILABLE);
-         cout << "Reservation expired. The book is now available." << endl;
-         return;
+     return copies;
+ }
+ 
+ // Checks out a copy of the title scanned at the desk: the copy the patron
+ // is holding, if any, otherwise the first available one. bookId is set to
+ // the copy chosen, or the first copy if none could be borrowed.
+ OpStatus Library::borrowBookByIsbn(User *user, const string &isbn, long long currentTime, int &bookId) {
+     bookId = 0;
+     uint64_t key = isbnKey(isbn);
+     if (key == 0)
+         return OP_INVALID_ISBN;
+     const vector<int> &copies = isbnIndex.find(key);
+     if (copies.empty())
+         return OP_BOOK_NOT_FOUND;
+     bookId = copies.front();
+     for (int id : copies) {
+         Book *book = books.find(id);
+         if (user && book->getStatus() == RESERVED && book->getReservedBy() == user->getUserId()) {
+             bookId = id;
+             return borrowReservedBook(user, id, currentTime);
+         }
      }
-     if (book->getStatus() != RESERVED || book->getReservedBy() != user->getUserId()) {
-         cout << "No reserved book found for you with this ID." << endl;
-         return;
+     for (int id : copies) {
+         if (books.find(id)->getStatus() == AVAILABLE) {
+             bookId = id;
+             return borrowBook(user, id, currentTime);
+         }
+     }
+     return OP_BOOK_NOT_AVAILABLE;
+ }
+ 
+ // Books and users are kept in ascending ID order, so a page resumes with a
+ // binary search for the first ID after the token. Search results are in ID
+ // order too, so each page is cut from the same cached list.
+ Page<Book *> Library::searchBooks(const string &term, int token, int pageSize) {
+     Page<Book *> page = {{}, token, false};
+     const vector<Book *> &matches = termMatches(foldText(term));
+     auto it = upper_bound(matches.begin(), matches.end(), token,
+                           [](int id, Book *b) { return id < b->getBookId(); });
+     for (; it != matches.end() && static_cast<int>(page.items.size()) < pageSize; ++it)
+         page.items.push_back(*it);
+     if (!page.items.empty())
+         page.nextToken = page.items.back()->getBookId();
+     page.hasMore = it != matches.end();
+     return page;
+ }
+ 
+ SearchCacheStats Library::getSearchCacheStats() const {
+     return searchCache.stats();
+ }
+ 
+ void Library::setSearchCacheCapacity(size_t entries) {
+     searchCache.setCapacity(entries);
+ }
+ 
+ Page<Book *> Library::listBooks(int token, int pageSize) {
+     Page<Book *> page = {{}, token, false};
+     auto it = books.upperBound(token);
+     for (; it != books.end() && static_cast<int>(page.items.size()) < pageSize; ++it)
+         page.items.push_back(*it);
+     if (!page.items.empty())
+         page.nextToken = page.items.back()->getBookId();
+     page.hasMore = it != books.end();
+     return page;
+ }
+ 
+ // Paged-out users on the page are read back in, so the listing always shows
+ // complete accounts.
+ Page<User *> Library::listUsers(int token, int pageSize) {
+     Page<User *> page = {{}, token, false};
+     auto it = users.upperBound(token);
+     const auto &paged = pager.index();
+     auto pit = paged.upper_bound(token);
+     vector<int> pagedIds;
+     vector<size_t> pagedSlots;
+     while ((it != users.end() || pit != paged.end()) && static_cast<int>(page.items.size()) < pageSize) {
+         if (pit == paged.end() || (it != users.end() && (*it)->getUserId() < pit->first)) {
+             page.items.push_back(*it++);
+         } else {
+             pagedSlots.push_back(page.items.size());
+             pagedIds.push_back((pit++)->first);
+             page.items.push_back(nullptr);
+         }
      }
-     user->borrowBook(book, currentTime, books);
-     logTransaction(user->getUserId(), "Borrowed reserved book " + to_string(bookId));
+     page.hasMore = it != users.end() || pit != paged.end();
+     for (size_t i = 0; i < pagedIds.size(); i++)
+         page.items[pagedSlots[i]] = faultIn(pagedIds[i]);
+     page.items.erase(remove(page.items.begin(), page.items.end(), nullptr), page.items.end());
+     if (!page.items.empty())
+         page.nextToken = page.items.back()->getUserId();
+     return page;
+ }
+ 
+ // History tokens are the index of the next record in the user's history.
+ Page<BorrowHistory> Library::listHistory(User *user, int token, int pageSize) {
+     Page<BorrowHistory> page = {{}, token, false};
+     if (!user) return page;
+     size_t total = history.countFor(user->getUserId());
+     size_t begin = min(total, static_cast<size_t>(max(0, token)));
+     page.items = history.forUser(user->getUserId(), begin, max(0, pageSize));
+     page.nextToken = begin + page.items.size();
+     page.hasMore = static_cast<size_t>(page.nextToken) < total;
+     return page;
+ }
+ 
+ const LoanEntry *Library::findLoan(int bookId) const {
+     return loans.find(bookId);
+ }
+ 
+ // 1 for the patron holding the reservation, 0 if the user has no hold.
+ int Library::holdPosition(User *user, int bookId) const {
+     return user ? holds.position(bookId, user->getUserId()) : 0;
+ }
+ 
+ vector<Hold> Library::getHoldQueue(int bookId) const {
+     return holds.queue(bookId);
  }
  
- void Library::searchBooks(const string &term) {
-     cout << endl << "Search results for \"" << term << "\":" << endl;
-     bool found = false;
+ // Cross-checks the loan table against the accounts, the book statuses and
+ // the due-date index, and reservations against the users. Returns one line
+ // per problem found; an empty result means everything agrees.
+ vector<string> Library::checkConsistency() const {
+     vector<string> problems;
+     size_t accountLoans = 0;
+     for (auto u : users) {
+         for (const auto &bb : u->getAccount().getBorrowedBooks()) {
+             accountLoans++;
+             const LoanEntry *loan = loans.find(bb.bookId);
+             if (!loan || loan->userId != u->getUserId() || loan->borrowTime != bb.borrowTime)
+                 problems.push_back("Loan of book " + to_string(bb.bookId) + " to user " +
+                                    to_string(u->getUserId()) + " is missing from the loan table");
+         }
+     }
+     for (const auto &entry : loans.entries()) {
+         int bookId = entry.first, userId = entry.second.userId;
+         Book *book = books.find(bookId);
+         if (!book)
+             problems.push_back("Book " + to_string(bookId) + " is on loan but not in the catalog");
+         else if (book->getStatus() != BORROWED)
+             problems.push_back("Book " + to_string(bookId) + " is on loan but marked " +
+                                statusToString(book->getStatus()));
+         if (!users.find(userId))
+             problems.push_back("Book " + to_string(bookId) + " is on loan to missing user " + to_string(userId));
+     }
+     if (accountLoans != loans.size())
+         problems.push_back("Accounts hold " + to_string(accountLoans) + " loans but the loan table has " +
+                            to_string(loans.size()));
+     if (static_cast<size_t>(dueIndex.size()) != loans.size())
+         problems.push_back("Due-date index has " + to_string(dueIndex.size()) + " loans but the loan table has " +
+                            to_string(loans.size()));
      for (auto b : books) {
-         string title = b->getTitle(), author = b->getAuthor();
-         transform(title.begin(), title.end(), title.begin(), ::tolower);
-         transform(author.begin(), author.end(), author.begin(), ::tolower);
-         string termLower = term;
-         transform(termLower.begin(), termLower.end(), termLower.begin(), ::tolower);
-         if (title.find(termLower) != string::npos || author.find(termLower) != string::npos) {
-             b->printDetails();
-             cout << "---------------------" << endl;
-             found = true;
+         if (b->getStatus() == BORROWED && !loans.find(b->getBookId()))
+             problems.push_back("Book " + to_string(b->getBookId()) + " is marked Borrowed but has no loan");
+         Hold front;
+         bool queued = holds.front(b->getBookId(), front);
+         if (queued ? front.userId != b->getReservedBy() : b->getReservedBy() != 0)
+             problems.push_back("Reservation on book " + to_string(b->getBookId()) +
+                                " does not match the front of its hold queue");
+     }
+     for (int bookId : holds.books()) {
+         for (const Hold &h : holds.queue(bookId)) {
+             if (!users.find(h.userId) && !pager.contains(h.userId))
+                 problems.push_back("Book " + to_string(bookId) + " is reserved by missing user " +
+                                    to_string(h.userId));
          }
      }
-     if (!found)
-         cout << "No matching books found." << endl;
+     vector<string> reportProblems = checkReports();
+     problems.insert(problems.end(), reportProblems.begin(), reportProblems.end());
+     return problems;
+ }
+ 
+ // Fines and open loans recomputed from every account, paged out or not.
+ CirculationTotals Library::tallyCirculation() const {
+     CirculationTotals totals = {0, 0, {}};
+     visitUsers([&totals](User *u) {
+         long long fine = u->getAccount().getFineCents();
+         totals.fineCents += fine;
+         totals.usersWithFines += fine > 0;
+         int open = u->getAccount().getBorrowedCount();
+         if (open > 0)
+             totals.loansByRole[u->getRole()] += open;
+     });
+     return totals;
+ }
+ 
+ // Borrows of each book still in the catalog with a borrow time in
+ // [begin, end), from the history and the open loans.
+ unordered_map<int, int> Library::tallyBorrows(long long begin, long long end) const {
+     unordered_map<int, int> counts;
+     auto count = [&](int bookId, long long borrowTime) {
+         if (borrowTime >= begin && borrowTime < end && books.find(bookId))
+             counts[bookId]++;
+     };
+     visitUsers([&](User *u) {
+         for (const auto &bb : u->getAccount().getBorrowedBooks())
+             count(bb.bookId, bb.borrowTime);
+         history.forEachRecord(u->getUserId(), [&](const BorrowHistory &h) { count(h.bookId, h.borrowTime); });
+     });
+     return counts;
+ }
+ 
+ // Moves the monthly ranking on to the current month, rebuilding it from the
+ // history if it was marked stale.
+ void Library::refreshMonthlyRanking() {
+     long long currentTime = now();
+     reports.rollTo(currentTime);
+     if (!reports.monthIsStale())
+         return;
+     reports.startMonth(currentTime);
+     for (const auto &entry : tallyBorrows(reports.monthBegin(), reports.monthEnd())) {
+         for (int i = 0; i < entry.second; i++)
+             reports.countBorrow(entry.first, reports.monthBegin());
+     }
+ }
+ 
+ CirculationReport Library::getCirculationReport(size_t topCount) {
+     refreshMonthlyRanking();
+     const CirculationTotals &totals = reports.totals();
+     CirculationReport report = {totals.fineCents, totals.usersWithFines, totals.loansByRole, loans.size(),
+                                 holds.bookCount(), holds.size(), reports.monthBegin(), {}};
+     for (const auto &entry : reports.topBorrowed(topCount))
+         report.mostBorrowed.push_back({books.find(entry.first), entry.second});
+     return report;
+ }
+ 
+ // Summarises every completed loan (see HistoryAnalytics.h), including the
+ // history still on disk, which is streamed rather than loaded; records of
+ // removed users are left out.
+ void Library::analyzeCirculation(HistoryAnalytics &result, int threads) {
+     vector<uint8_t> rowRoles(history.residentSize(), NO_ROLE);
+     vector<string> roleNames;
+     unordered_map<int, uint8_t> userRoles;
+     visitUsers([&](User *u) {
+         auto it = find(roleNames.begin(), roleNames.end(), u->getRole());
+         uint8_t role = static_cast<uint8_t>(it - roleNames.begin());
+         if (it == roleNames.end())
+             roleNames.push_back(u->getRole());
+         userRoles[u->getUserId()] = role;
+         for (uint32_t row : history.rowsFor(u->getUserId()))
+             rowRoles[row] = role;
+     });
+     analyzeHistory(history, rowRoles, userRoles, roleNames, result, threads);
+ }
+ 
+ // Recomputes the circulation report from scratch and lists every figure
+ // that differs from the maintained one.
+ vector<string> Library::checkReports() const {
+     vector<string> problems;
+     CirculationTotals expected = tallyCirculation();
+     const CirculationTotals &kept = reports.totals();
+     if (kept.fineCents != expected.fineCents)
+         problems.push_back("Report shows " + to_string(kept.fineCents) + " paise of fines but accounts owe " +
+                            to_string(expected.fineCents));
+     if (kept.usersWithFines != expected.usersWithFines)
+         problems.push_back("Report shows " + to_string(kept.usersWithFines) + " users with fines but " +
+                            to_string(expected.usersWithFines) + " owe one");
+     if (kept.loansByRole != expected.loansByRole)
+         problems.push_back("Report's open loans by role do not match the accounts");
+     size_t reserved = 0;
+     for (auto b : books)
+         reserved += b->getReservedBy() != 0;
+     if (reserved != holds.bookCount())
+         problems.push_back("Hold queues cover " + to_string(holds.bookCount()) + " books but " +
+                            to_string(reserved) + " are reserved");
+     if (reports.monthIsStale())
+         return problems;
+     unordered_map<int, int> borrows = tallyBorrows(reports.monthBegin(), reports.monthEnd());
+     if (borrows.size() != reports.booksThisMonth())
+         problems.push_back("Report ranks " + to_string(reports.booksThisMonth()) + " books this month but " +
+                            to_string(borrows.size()) + " were borrowed");
+     for (const auto &entry : borrows) {
+         int shown = reports.borrowsThisMonth(entry.first);
+         if (shown != entry.second)
+             problems.push_back("Book " + to_string(entry.first) + " was borrowed " + to_string(entry.second) +
+                                " times this month but the report shows " + to_string(shown));
+     }
+     vector<pair<int, int>> ranking = reports.topBorrowed(reports.booksThisMonth());
+     if (!is_sorted(ranking.begin(), ranking.end(),
+                    [](const pair<int, int> &a, const pair<int, int> &b) { return a.second > b.second; }))
+         problems.push_back("Monthly ranking is out of order");
+     return problems;
  }
  
  User *Library::findUser(int userId) {
-     for (auto u : users) {
-         if (u->getUserId() == userId)
-             return u;
+     User *u = users.find(userId);
+     if (u) {
+         pageHits++;
+         touch(u);
+         return u;
      }
+     if (pager.contains(userId))
+         return faultIn(userId);
      return nullptr;
  }
  
  Book *Library::findBook(int bookId) {
-     for (auto b : books) {
-         if (b->getBookId() == bookId)
-             return b;
-     }
-     return nullptr;
+     return books.find(bookId);
  }
  
  User *Library::login(const string &uname, const string &pwd) {
      for (auto u : users) {
-         if (u->authenticate(uname, pwd))
+         if (u->authenticate(uname, pwd)) {
+             pageHits++;
+             touch(u);
              return u;
+         }
+     }
+     int pagedId = pager.findUsername(uname);
+     if (pagedId != 0) {
+         User *user = faultIn(pagedId);
+         if (user && user->authenticate(uname, pwd))
+             return user;
      }
      return nullptr;
  }
  
- void Library::displayBooks() {
-     for (auto b : books) {
-         b->printDetails();
-         cout << "---------------------" << endl;
-     }
+ OpStatus Library::borrowBook(User *user, int bookId, long long currentTime) {
+     if (!user)
+         return OP_INVALID_USER;
+     Book *book = findBook(bookId);
+     if (!book)
+         return OP_BOOK_NOT_FOUND;
+     OpStatus status = applyBorrow(user, book, currentTime);
+     if (status == OP_OK)
+         logTransaction(user->getUserId(), "Borrowed book " + to_string(bookId));
+     return status;
  }
  
- void Library::borrowBook(User *user, int bookId, long long currentTime) {
-     if (!user) {
-         cout << "Invalid user." << endl;
-         return;
-     }
+ ReturnResult Library::returnBook(User *user, int bookId, long long returnTime) {
+     if (!user)
+         return {OP_INVALID_USER, 0, 0.0};
      Book *book = findBook(bookId);
-     if (!book) {
-         cout << "Book not found." << endl;
-         return;
-     }
-     if (book->getStatus() != AVAILABLE) {
-         cout << "Book is not available for borrowing." << endl;
-         return;
-     }
-     if (user->borrowBook(book, currentTime, books))
-         logTransaction(user->getUserId(), "Borrowed book " + to_string(bookId));
+     if (!book)
+         return {OP_BOOK_NOT_FOUND, 0, 0.0};
+     ReturnResult result = applyReturn(user, book, returnTime);
+     if (result.status == OP_OK)
+         logTransaction(user->getUserId(), "Returned book " + to_string(bookId));
+     return result;
  }
  
- void Library::returnBook(User *user, int bookId, long long returnTime) {
+ // Borrows several books for one user. Every book is resolved and checked for
+ // availability first; the eligible ones are then borrowed in order (so the
+ // user's limit is applied as it fills up) and logged with a single write.
+ vector<OpStatus> Library::borrowMany(User *user, const vector<int> &bookIds, long long currentTime) {
+     vector<OpStatus> results(bookIds.size(), OP_OK);
      if (!user) {
-         cout << "Invalid user." << endl;
-         return;
+         fill(results.begin(), results.end(), OP_INVALID_USER);
+         return results;
      }
-     Book *book = findBook(bookId);
-     if (!book) {
-         cout << "Book not found." << endl;
-         return;
+     vector<Book *> resolved(bookIds.size(), nullptr);
+     for (size_t i = 0; i < bookIds.size(); i++) {
+         resolved[i] = findBook(bookIds[i]);
+         if (!resolved[i])
+             results[i] = OP_BOOK_NOT_FOUND;
+         else if (resolved[i]->getStatus() != AVAILABLE)
+             results[i] = OP_BOOK_NOT_AVAILABLE;
+     }
+     vector<pair<int, string>> log;
+     for (size_t i = 0; i < bookIds.size(); i++) {
+         if (results[i] != OP_OK) continue;
+         // A book listed twice is no longer available the second time.
+         if (resolved[i]->getStatus() != AVAILABLE) {
+             results[i] = OP_BOOK_NOT_AVAILABLE;
+             continue;
+         }
+         results[i] = applyBorrow(user, resolved[i], currentTime);
+         if (results[i] == OP_OK)
+             log.push_back({user->getUserId(), "Borrowed book " + to_string(bookIds[i])});
      }
-     user->returnBook(book, returnTime);
-     logTransaction(user->getUserId(), "Returned book " + to_string(bookId));
+     logTransactions(log);
+     return results;
  }
  
- void Library::payFine(User *user) {
-     if (!user) {
-         cout << "Invalid user." << endl;
-         return;
+ // Returns a stack of books, e.g. from the book drop. Items are grouped by user
+ // so each borrower is looked up once; results are reported in input order.
+ vector<ReturnResult> Library::returnMany(const vector<LoanRequest> &items, long long returnTime) {
+     vector<ReturnResult> results(items.size(), ReturnResult{OP_OK, 0, 0.0});
+     vector<pair<int, string>> log;
+     vector<size_t> order = orderByUser(items);
+     User *user = nullptr;
+     for (size_t k = 0; k < order.size(); k++) {
+         const LoanRequest &item = items[order[k]];
+         if (k == 0 || items[order[k - 1]].userId != item.userId)
+             user = findUser(item.userId);
+         Book *book = findBook(item.bookId);
+         if (!user)
+             results[order[k]] = {OP_USER_NOT_FOUND, 0, 0.0};
+         else if (!book)
+             results[order[k]] = {OP_BOOK_NOT_FOUND, 0, 0.0};
+         else
+             results[order[k]] = applyReturn(user, book, returnTime);
+         if (results[order[k]].status == OP_OK)
+             log.push_back({item.userId, "Returned book " + to_string(item.bookId)});
      }
-     double before = user->getAccount().getFine();
-     cout << "Fine before payment: " << before << endl;
-     user->getAccount().payFine();
-     cout << "Fine paid. Current fine: " << user->getAccount().getFine() << endl;
-     logTransaction(user->getUserId(), "Paid fine of " + to_string(before));
+     logTransactions(log);
+     return results;
  }
  
- void Library::displayUsers() {
-     for (auto u : users) {
-         u->printDetails();
-         cout << "Current borrowed books: " << u->getAccount().getBorrowedCount() << endl;
-         cout << "Outstanding fine: " << u->getAccount().getFine() << endl;
-         cout << "---------------------" << endl;
-     }
- }
- 
- void Library::displayFullBorrowHistory(User *user) {
-     const auto &currentBorrows = user->getAccount().getBorrowedBooks();
-     if (!currentBorrows.empty()) {
-         cout << endl << "Currently Borrowed Books:" << endl;
-         for (const auto &bb : currentBorrows) {
-             Book *book = findBook(bb.bookId);
-             if (book) {
-                 cout << "Book ID: " << bb.bookId << " - " << book->getTitle() 
-                      << " | Borrowed at: " << bb.borrowTime << endl;
-             }
-         }
-     } else {
-         cout << endl << "No books are currently borrowed." << endl;
-     }
-     const auto &hist = user->getAccount().getHistory();
-     if (!hist.empty()) {
-         cout << endl << "Past Borrowing History:" << endl;
-         for (const auto &h : hist) {
-             Book *book = findBook(h.bookId);
-             if (book) {
-                 cout << "Book ID: " << h.bookId << " - " << book->getTitle() 
-                      << " | Borrowed at: " << h.borrowTime 
-                      << " | Returned at: " << h.returnTime 
-                      << " | Overdue Days: " << h.overdueDays 
-                      << " | Fine Charged: " << h.fineCharged << endl;
-             }
-         }
-     } else {
-         cout << endl << "No past borrowing history found." << endl;
+ vector<OpStatus> Library::renewMany(const vector<LoanRequest> &items, long long currentTime) {
+     vector<OpStatus> results(items.size(), OP_OK);
+     vector<pair<int, string>> log;
+     vector<size_t> order = orderByUser(items);
+     User *user = nullptr;
+     for (size_t k = 0; k < order.size(); k++) {
+         const LoanRequest &item = items[order[k]];
+         if (k == 0 || items[order[k - 1]].userId != item.userId)
+             user = findUser(item.userId);
+         Book *book = findBook(item.bookId);
+         if (!user)
+             results[order[k]] = OP_USER_NOT_FOUND;
+         else if (!book)
+             results[order[k]] = OP_BOOK_NOT_FOUND;
+         else
+             results[order[k]] = applyRenew(user, book, currentTime);
+         if (results[order[k]] == OP_OK)
+             log.push_back({item.userId, "Renewed book " + to_string(item.bookId)});
      }
+     logTransactions(log);
+     return results;
  }
  
- void Library::addNewUser() {
-     cin.ignore();
-     cout << "Enter user type (Student, Faculty, Librarian): " << endl;
-     string type;
-     getline(cin, type);
- 
-     cout << "Enter name: " << endl;
-     string name;
-     getline(cin, name);
- 
-     cout << "Enter username: " << endl;
-     string uname;
-     getline(cin, uname);
- 
-     cout << "Enter password: " << endl;
-     string pwd;
-     getline(cin, pwd);
+ OpStatus Library::payFine(User *user, double &amountPaid) {
+     if (!user)
+         return OP_INVALID_USER;
+     amountPaid = user->getAccount().getFine();
+     reports.fineChanged(user->getAccount().getFineCents(), 0);
+     user->getAccount().payFine();
+     logTransaction(user->getUserId(), "Paid fine of " + to_string(amountPaid));
+     return OP_OK;
+ }
  
+ User *Library::addNewUser(const string &type, const string &name, const string &uname, const string &pwd) {
      User *newUser = nullptr;
      if (type == "Student" || type == "student") {
          newUser = new Student(nextUserId, name, uname, pwd, false);
@@ -630,24 +1360,126 @@
      } else if (type == "Librarian" || type == "librarian") {
          newUser = new Librarian(nextUserId, name, uname, pwd, false);
      } else {
-         cout << "Invalid user type." << endl;
-         return;
+         return nullptr;
      }
      addUser(newUser);
-     nextUserId++;
      logTransaction(newUser->getUserId(), "Added new user (" + newUser->getRole() + ")");
+     return newUser;
  }
  
- void Library::removeUser(int userId) {
-     for (auto it = users.begin(); it != users.end(); ++it) {
-         if ((*it)->getUserId() == userId) {
-             cout << "Removing user: " << (*it)->getName() << endl;
-             logTransaction(userId, "Removed user (" + (*it)->getRole() + ")");
-             delete *it;
-             users.erase(it);
-             return;
+ OpStatus Library::removeUser(int userId) {
+     if (pager.contains(userId))
+         faultIn(userId);
+     User *user = users.erase(userId);
+     if (!user)
+         return OP_USER_NOT_FOUND;
+     logTransaction(userId, "Removed user (" + user->getRole() + ")");
+     reports.fineChanged(user->getAccount().getFineCents(), 0);
+     // Their loans and history no longer count towards this month's ranking.
+     if (user->getAccount().getBorrowedCount() > 0 || history.countFor(userId) > 0)
+         reports.invalidateMonth();
+     // Books the user still had go back on the shelf (or to whoever reserved
+     // them), and their own reservations are released.
+     for (const auto &bb : user->getAccount().getBorrowedBooks()) {
+         dueIndex.remove(userId, bb.bookId);
+         loans.remove(bb.bookId);
+         reports.loanClosed(user->getRole());
+         Book *book = findBook(bb.bookId);
+         if (!book)
+             continue;
+         book->setStatus(book->getReservedBy() != 0 ? RESERVED : AVAILABLE);
+         statusVersion++;
+         if (book->getReservedBy() != 0) {
+             book->setReserveTime(now());
+             reservationWheel.schedule(bb.bookId, reservationDeadline(book->getReserveTime()));
          }
      }
-     cout << "User with ID " << userId << " not found." << endl;
+     for (int bookId : holds.booksHeldBy(userId)) {
+         Book *book = findBook(bookId);
+         bool front = holds.position(bookId, userId) == 1;
+         holds.remove(bookId, userId);
+         if (book && front)
+             promoteNextHold(book, now());
+     }
+     history.removeUser(userId);
+     auto pos = lruPos.find(userId);
+     if (pos != lruPos.end()) {
+         lru.erase(pos->second);
+         lruPos.erase(pos);
+     }
+     if (activeUser == user)
+         activeUser = nullptr;
+     delete user;
+     return OP_OK;
+ }
+ 
+ long long Library::dueTimeFor(User *user, long long borrowTime) const {
+     return borrowTime + static_cast<long long>(user->getBorrowPeriod()) * 24 * 60;
+ }
+ 
+ // The apply* helpers perform one circulation change on already-resolved
+ // objects and keep the indexes in step, but leave logging to the caller.
+ OpStatus Library::applyBorrow(User *user, Book *book, long long currentTime) {
+     if (book->getStatus() != AVAILABLE)
+         return OP_BOOK_NOT_AVAILABLE;
+     OpStatus status = user->borrowBook(book, currentTime);
+     if (status == OP_OK) {
+         statusVersion++;
+         dueIndex.add(user->getUserId(), book->getBookId(), dueTimeFor(user, currentTime));
+         loans.add(book->getBookId(), user->getUserId(), currentTime);
+         reports.loanOpened(user->getRole(), book->getBookId(), currentTime);
+     }
+     return status;
+ }
+ 
+ ReturnResult Library::applyReturn(User *user, Book *book, long long returnTime) {
+     BorrowHistory record;
+     long long fineBefore = user->getAccount().getFineCents();
+     if (!user->returnBook(book, returnTime, record))
+         return {OP_NOT_BORROWED, 0, 0.0};
+     statusVersion++;
+     reports.loanClosed(user->getRole());
+     reports.fineChanged(fineBefore, user->getAccount().getFineCents());
+     dueIndex.remove(user->getUserId(), book->getBookId());
+     loans.remove(book->getBookId());
+     history.append(user->getUserId(), record);
+     // The front holder's collection window starts when the book comes back.
+     if (book->getReservedBy() != 0) {
+         book->setReserveTime(returnTime);
+         reservationWheel.schedule(book->getBookId(), reservationDeadline(returnTime));
+     }
+     return {OP_OK, record.overdueDays, record.fineCharged};
+ }
+ 
+ OpStatus Library::applyRenew(User *user, Book *book, long long currentTime) {
+     if (book->getReservedBy() != 0)
+         return OP_RESERVED_BY_OTHER;
+     const LoanEntry *loan = loans.find(book->getBookId());
+     long long previousBorrowTime = loan ? loan->borrowTime : currentTime;
+     if (!user->getAccount().renewBorrowedBook(book->getBookId(), currentTime))
+         return OP_NOT_BORROWED;
+     dueIndex.update(user->getUserId(), book->getBookId(), dueTimeFor(user, currentTime));
+     loans.renew(book->getBookId(), currentTime);
+     reports.loanRenewed(book->getBookId(), previousBorrowTime, currentTime);
+     return OP_OK;
+ }
+ 
+ // Indices of items sorted by user (stable, so each user's items keep their order).
+ vector<size_t> Library::orderByUser(const vector<LoanRequest> &items) const {
+     vector<size_t> order(items.size());
+     for (size_t i = 0; i < order.size(); i++)
+         order[i] = i;
+     stable_sort(order.begin(), order.end(), [&items](size_t a, size_t b) {
+         return items[a].userId < items[b].userId;
+     });
+     return order;
+ }
+ 
+ void Library::collectOpenLoans(LoanColumns &loans) {
+     loans.clear();
+     for (auto u : users) {
+         for (const auto &bb : u->getAccount().getBorrowedBooks())
+             loans.add(u->getUserId(), bb.bookId, bb.borrowTime, u->getBorrowPeriod(), u->getFinePerDay());
+     }
  }
  
\ No newline at end of file
@@ -5,60 +5,231 @@
  * integrating books, users, and file operations.
  *
  * The Library class provides methods to:
- * - Add, remove, and update books.
+ * - Add, remove, and update books, or import a whole vendor feed at once.
  * - Manage user accounts (including adding and removing users, for librarians).
- * - Process borrowing and returning transactions.
- * - Perform advanced searches.
- * - Load data from and save data to CSV files for data persistence.
+ * - Process borrowing and returning transactions, singly or in bulk.
+ * - Perform advanced searches, and complete partly typed titles and authors
+ *   into the most borrowed matching books. Recent search results are cached
+ *   until the catalog (or, for results that depend on it, circulation)
+ *   changes.
+ * - List books, users, search results and history a page at a time.
+ * - Queue any number of patrons for a book, promoting the next one when a
+ *   hold is collected, cancelled or expires (uncollected within 7 days of
+ *   the book coming back).
+ * - Report overdue and soon-due loans across the whole library.
+ * - Find who holds a given book, and check the loan records for consistency.
+ * - Report outstanding fines, open loans per role, reserved books and the
+ *   month's most borrowed books from figures kept up to date by each
+ *   operation (see CirculationReports.h), checked against a full recount.
+ * - Analyse the whole borrowing history per day, week and role in parallel.
+ * - Find every copy of a title by ISBN (10 or 13 digits, validated) in O(1),
+ *   and check out an available copy from a scanned ISBN.
+ * - Project the fines accrued so far on books that are still out.
+ * - Load data from and save data to CSV files for data persistence, serving
+ *   the catalog text from a memory-mapped segment that each save refreshes.
+ * - Optionally keep only a bounded number of accounts in memory, paging the
+ *   least recently used accounts without open loans out to disk.
+ *
+ * The Library does no console I/O: operations return an OpStatus (or a result
+ * struct) and queries return the matching books, leaving presentation to
+ * LibraryConsole. The current time is read from an injectable Clock (the
+ * system clock by default), so whole sessions can be replayed against a
+ * virtual clock.
+ *
+ * Books and users are held in SlotMaps keyed by their IDs, so lookups by ID
+ * and removals are O(1) and never move other records.
+ *
+ * Under a memory budget getUsers() returns only the resident users. Paged-out
+ * users are read back transparently by findUser() and login(), are included
+ * in listUsers() and getUsersCount(), and are visited by visitUsers().
  */
 
 #ifndef LIBRARY_H
 #define LIBRARY_H
 
 #include "Book.h"
+#include "CatalogImport.h"
+#include "CatalogSegment.h"
 #include "User.h"
+#include "Status.h"
+#include "ReservationWheel.h"
+#include "DueDateIndex.h"
+#include "LoanTable.h"
+#include "HoldQueues.h"
+#include "Isbn.h"
+#include "CirculationReports.h"
+#include "PrefixIndex.h"
+#include "SearchCache.h"
+#include "HistoryStore.h"
+#include "HistoryAnalytics.h"
+#include "FineAccrual.h"
+#include "Clock.h"
+#include "AccountPager.h"
+#include "SlotMap.h"
+#include <functional>
+#include <list>
+#include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
+#include <utility>
 using namespace std;
 
+struct ReturnResult {
+    OpStatus status;
+    int overdueDays;
+    double fineCharged;
+};
+
+struct LoanRequest {
+    int userId;
+    int bookId;
+};
+
+struct PagingStats {
+    long long hits;
+    long long faults;
+    long long evictions;
+    size_t residentUsers;
+    size_t pagedUsers;
+    size_t residentBytes;
+    size_t pageIndexBytes;
+};
+
+// The librarian's circulation report. The most borrowed books are those of
+// the calendar month starting at monthBegin, highest count first.
+struct CirculationReport {
+    long long fineCents;
+    int usersWithFines;
+    map<string, int> loansByRole;
+    size_t openLoans;
+    size_t reservedBooks;
+    size_t waitingPatrons;
+    long long monthBegin;
+    vector<pair<Book *, int>> mostBorrowed;
+};
+
+// One page of a listing. Pass nextToken back to fetch the following page
+// (start with 0); hasMore is false on the last page. Book and user tokens are
+// the last ID returned, so pages stay correct while records are added.
+template <typename T>
+struct Page {
+    vector<T> items;
+    int nextToken;
+    bool hasMore;
+};
+
 class Library {
 public:
     Library();
     ~Library();
 
+    void setClock(Clock *c);
+    long long now() const;
+    unsigned long long stateChecksum() const;
+
     void addUser(User *user);
     int getBooksCount() const;
     int getUsersCount() const;
-    void checkOverdueNotifications(User *user, long long currentTime);
-    void renewBook(User *user, int bookId, long long currentTime);
-    void cancelReservation(User *user, int bookId);
-    void advancedSearchBooks();
+    const SlotMap<Book> &getBooks() const;
+    const SlotMap<User> &getUsers() const;
+    const DueDateIndex &getDueIndex() const;
+    const HistoryStore &getHistoryStore() const;
+    HistoryStore &getHistoryStore();
+    void visitUsers(const function<void(User *)> &fn) const;
+
+    void setMemoryBudget(size_t maxResidentUsers, const string &pagePath = "accounts.page");
+    void setActiveUser(User *user);
+    void trimToBudget();
+    PagingStats getPagingStats() const;
+    SearchCacheStats getSearchCacheStats() const;
+    void setSearchCacheCapacity(size_t entries);
+    OpStatus renewBook(User *user, int bookId, long long currentTime);
+    OpStatus cancelReservation(User *user, int bookId);
+    void expireReservations(long long currentTime);
+    vector<Book *> advancedSearchBooks(const string &term, int yearFilter, int availFilter, int sortOption,
+                                       bool fuzzy);
     void loadData();
     void saveData();
-    void addBook(const string &title, const string &author,
-                 const string &publisher, int year, const string &isbn);
-    void removeBook(int bookId);
-    void updateBookDetails(int bookId);
-    void reserveBook(User *user, int bookId);
-    void borrowReservedBook(User *user, int bookId, long long currentTime);
-    void searchBooks(const string &term);
+    int addBook(const string &title, const string &author,
+                const string &publisher, int year, const string &isbn);
+    ImportResult importCatalog(const string &path, int threads = 0);
+    OpStatus removeBook(int bookId);
+    OpStatus updateBookDetails(int bookId, const string &title, const string &author,
+                               const string &publisher, int year, const string &isbn);
+    OpStatus reserveBook(User *user, int bookId, long long currentTime);
+    OpStatus borrowReservedBook(User *user, int bookId, long long currentTime);
+    vector<Book *> searchBooks(const string &term);
+    vector<Book *> autocomplete(const string &text, int limit) const;
+    vector<Book *> findBooksByIsbn(const string &isbn) const;
+    OpStatus borrowBookByIsbn(User *user, const string &isbn, long long currentTime, int &bookId);
+    Page<Book *> searchBooks(const string &term, int token, int pageSize);
+    Page<Book *> listBooks(int token, int pageSize);
+    Page<User *> listUsers(int token, int pageSize);
+    Page<BorrowHistory> listHistory(User *user, int token, int pageSize);
     User *findUser(int userId);
     Book *findBook(int bookId);
+    const LoanEntry *findLoan(int bookId) const;
+    int holdPosition(User *user, int bookId) const;
+    vector<Hold> getHoldQueue(int bookId) const;
+    vector<string> checkConsistency() const;
+    CirculationReport getCirculationReport(size_t topCount);
+    vector<string> checkReports() const;
+    void analyzeCirculation(HistoryAnalytics &result, int threads = 0);
     User *login(const string &uname, const string &pwd);
-    void displayBooks();
-    void borrowBook(User *user, int bookId, long long currentTime);
-    void returnBook(User *user, int bookId, long long returnTime);
-    void payFine(User *user);
-    void displayUsers();
-    void displayFullBorrowHistory(User *user);
-    void addNewUser();     
-    void removeUser(int userId); 
+    OpStatus borrowBook(User *user, int bookId, long long currentTime);
+    ReturnResult returnBook(User *user, int bookId, long long returnTime);
+    vector<OpStatus> borrowMany(User *user, const vector<int> &bookIds, long long currentTime);
+    vector<ReturnResult> returnMany(const vector<LoanRequest> &items, long long returnTime);
+    vector<OpStatus> renewMany(const vector<LoanRequest> &items, long long currentTime);
+    OpStatus payFine(User *user, double &amountPaid);
+    User *addNewUser(const string &type, const string &name, const string &uname, const string &pwd);
+    OpStatus removeUser(int userId);
+    void collectOpenLoans(LoanColumns &loans);
 
 private:
-    vector<Book *> books;
-    vector<User *> users;
+    void releaseReservation(Book *book, long long currentTime);
+    void promoteNextHold(Book *book, long long currentTime);
+    long long dueTimeFor(User *user, long long borrowTime) const;
+    OpStatus applyBorrow(User *user, Book *book, long long currentTime);
+    ReturnResult applyReturn(User *user, Book *book, long long returnTime);
+    OpStatus applyRenew(User *user, Book *book, long long currentTime);
+    vector<size_t> orderByUser(const vector<LoanRequest> &items) const;
+    void insertResident(User *user);
+    void touch(User *user);
+    User *faultIn(int userId);
+    void mergeCatalog();
+    const vector<Book *> &termMatches(const string &foldedTerm);
+    CirculationTotals tallyCirculation() const;
+    unordered_map<int, int> tallyBorrows(long long begin, long long end) const;
+    void refreshMonthlyRanking();
+
+    CatalogSegment catalog;
+    SlotMap<Book> books;
+    SlotMap<User> users;
     int nextBookId;
     int nextUserId;
+    SystemClock systemClock;
+    Clock *clock;
+    ReservationWheel reservationWheel;
+    DueDateIndex dueIndex;
+    LoanTable loans;
+    HoldQueues holds;
+    PrefixIndex prefixIndex;
+    IsbnIndex isbnIndex;
+    SearchCache searchCache;
+    uint64_t catalogVersion;
+    uint64_t statusVersion;
+    HistoryStore history;
+    CirculationReports reports;
+    size_t memoryBudget;
+    User *activeUser;
+    AccountPager pager;
+    list<User *> lru;
+    unordered_map<int, list<User *>::iterator> lruPos;
+    long long pageHits;
+    long long pageFaults;
+    long long pageEvictions;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,621 @@
+/*
+ * LibraryConsole.cpp
+ *
+ * This file implements the console front end declared in LibraryConsole.h.
+ * Each method performs one Library operation and prints the result in the
+ * same wording the menus have always used.
+ */
+
+#include "LibraryConsole.h"
+#include "Utility.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+using namespace std;
+
+LibraryConsole::LibraryConsole(Library &lib) : lib(lib), pageSize(20), prompting(true) {}
+
+void LibraryConsole::setPageSize(int size) {
+    if (size > 0)
+        pageSize = size;
+}
+
+void LibraryConsole::setPrompting(bool enabled) {
+    prompting = enabled;
+}
+
+void LibraryConsole::addUser(User *user) {
+    lib.addUser(user);
+    cout << "Added " << user->getRole() << ": " << user->getName() << endl;
+}
+
+void LibraryConsole::checkOverdueNotifications(User *user, long long currentTime) {
+    const Account &account = user->getAccount();
+    const set<pair<long long, int>> &loans = account.getLoansByDueTime();
+    if (loans.empty()) return;
+    cout << "\nOverdue Notifications:" << endl;
+    int allowedPeriod = user->getBorrowPeriod();
+    long long allowedTime = static_cast<long long>(allowedPeriod) * 24 * 60;
+    bool anyNotification = false;
+    // Loans come earliest due first, so the first one not yet near due ends the scan.
+    for (const auto &loan : loans) {
+        long long elapsed = currentTime - (loan.first - allowedTime);
+        if (elapsed < allowedTime * 0.8) break;
+        Book *book = lib.findBook(loan.second);
+        if (!book) continue;
+        if (elapsed >= allowedTime)
+            cout << "Book \"" << book->getTitle() << "\" is OVERDUE." << endl;
+        else
+            cout << "Book \"" << book->getTitle() << "\" is nearing its due date." << endl;
+        anyNotification = true;
+    }
+    if (!anyNotification)
+        cout << "No overdue or near-due notifications." << endl;
+}
+
+void LibraryConsole::renewBook(User *user, int bookId, long long currentTime) {
+    OpStatus status = lib.renewBook(user, bookId, currentTime);
+    if (status == OP_OK)
+        cout << "Book \"" << lib.findBook(bookId)->getTitle() << "\" renewed successfully." << endl;
+    else
+        cout << opStatusToString(status) << endl;
+}
+
+void LibraryConsole::cancelReservation(User *user, int bookId) {
+    OpStatus status = lib.cancelReservation(user, bookId);
+    if (status == OP_OK)
+        cout << "Reservation for book \"" << lib.findBook(bookId)->getTitle() << "\" cancelled." << endl;
+    else if (status == OP_NOT_RESERVED_BY_USER)
+        cout << "You did not reserve this book." << endl;
+    else
+        cout << opStatusToString(status) << endl;
+}
+
+void LibraryConsole::advancedSearchBooks() {
+    cin.ignore();
+    cout << "Enter search term (or press enter to skip): " << endl;
+    string term;
+    getline(cin, term);
+    cout << "Enter publication year to filter (or 0 to skip): " << endl;
+    int yearFilter;
+    cin >> yearFilter;
+    cout << "Filter by availability? (1: Available, 2: Borrowed, 3: Reserved, 0: skip): " << endl;
+    int availFilter;
+    cin >> availFilter;
+    cout << "Sort results (1: Popularity, 2: Recency, 0: none): " << endl;
+    int sortOption;
+    cin >> sortOption;
+    cout << "Allow spelling mistakes in the search term? (1: Yes, 0: No): " << endl;
+    int fuzzy;
+    cin >> fuzzy;
+    advancedSearchBooks(term, yearFilter, availFilter, sortOption, fuzzy == 1);
+}
+
+void LibraryConsole::advancedSearchBooks(const string &term, int yearFilter, int availFilter, int sortOption,
+                                         bool fuzzy) {
+    vector<Book *> results = lib.advancedSearchBooks(term, yearFilter, availFilter, sortOption, fuzzy);
+    if (!results.empty())
+        cout << "Advanced Search Results:" << endl;
+    printBookList(results);
+}
+
+void LibraryConsole::addBook(const string &title, const string &author,
+                             const string &publisher, int year, const string &isbn) {
+    if (lib.addBook(title, author, publisher, year, isbn) == 0) {
+        cout << opStatusToString(OP_INVALID_ISBN) << endl;
+        return;
+    }
+    cout << "Added book: " << title << endl;
+}
+
+void LibraryConsole::importCatalog(const string &path) {
+    ImportResult result = lib.importCatalog(path);
+    if (!result.opened) {
+        cout << "Cannot open feed " << path << endl;
+        return;
+    }
+    cout << "Imported " << result.added << " of " << result.rows << " titles from " << path << " ("
+         << result.duplicates << " already in the catalog, " << result.invalidIsbn << " with an invalid ISBN, "
+         << result.malformed << " malformed lines skipped)" << endl;
+    if (result.seconds > 0)
+        cout << "Parsed in " << result.parseSeconds << " s, " << result.seconds << " s in total ("
+             << static_cast<long long>(result.rows / result.seconds) << " rows/sec)" << endl;
+}
+
+void LibraryConsole::removeBook(int bookId) {
+    if (lib.removeBook(bookId) == OP_OK)
+        cout << "Removed book with ID: " << bookId << endl;
+    else
+        cout << "Book with ID " << bookId << " not found." << endl;
+}
+
+void LibraryConsole::updateBookDetails(int bookId) {
+    Book *book = lib.findBook(bookId);
+    if (!book) {
+        cout << "Book not found." << endl;
+        return;
+    }
+    string newTitle, newAuthor, newPublisher, newISBN;
+    int newYear;
+    cin.ignore();
+    cout << "Enter new title (or press enter to keep \"" << book->getTitle() << "\"):" << endl;
+    getline(cin, newTitle);
+    cout << "Enter new author (or press enter to keep \"" << book->getAuthor() << "\"):" << endl;
+    getline(cin, newAuthor);
+    cout << "Enter new publisher (or press enter to keep \"" << book->getPublisher() << "\"):" << endl;
+    getline(cin, newPublisher);
+    cout << "Enter new year (or 0 to keep \"" << book->getYear() << "\"):" << endl;
+    cin >> newYear;
+    cin.ignore();
+    cout << "Enter new ISBN (or press enter to keep \"" << book->getISBN() << "\"):" << endl;
+    getline(cin, newISBN);
+    updateBookDetails(bookId, newTitle, newAuthor, newPublisher, newYear, newISBN);
+}
+
+void LibraryConsole::updateBookDetails(int bookId, const string &title, const string &author,
+                                       const string &publisher, int year, const string &isbn) {
+    OpStatus status = lib.updateBookDetails(bookId, title, author, publisher, year, isbn);
+    if (status == OP_OK)
+        cout << "Book details updated." << endl;
+    else
+        cout << opStatusToString(status) << endl;
+}
+
+void LibraryConsole::reserveBook(User *user, int bookId, long long currentTime) {
+    OpStatus status = lib.reserveBook(user, bookId, currentTime);
+    if (status != OP_OK) {
+        cout << opStatusToString(status) << endl;
+        return;
+    }
+    int position = lib.holdPosition(user, bookId);
+    if (position == 1)
+        cout << "Book \"" << lib.findBook(bookId)->getTitle() << "\" reserved successfully." << endl;
+    else
+        cout << "Book \"" << lib.findBook(bookId)->getTitle() << "\" is already reserved. You are number "
+             << position << " in the queue." << endl;
+}
+
+void LibraryConsole::borrowReservedBook(User *user, int bookId, long long currentTime) {
+    printBorrowOutcome(user, bookId, lib.borrowReservedBook(user, bookId, currentTime));
+}
+
+void LibraryConsole::searchBooks(const string &term) {
+    cout << endl << "Search results for \"" << term << "\":" << endl;
+    int token = 0;
+    bool any = false;
+    while (true) {
+        Page<Book *> page = lib.searchBooks(term, token, pageSize);
+        ostringstream out;
+        for (auto b : page.items) {
+            b->printDetails(out);
+            out << "---------------------\n";
+        }
+        if (!any && page.items.empty())
+            out << "No matching books found.\n";
+        any = true;
+        writePage(out.str());
+        token = page.nextToken;
+        if (!page.hasMore || !continuePaging())
+            break;
+    }
+}
+
+void LibraryConsole::autocomplete(const string &text) {
+    vector<Book *> results = lib.autocomplete(text, pageSize);
+    ostringstream out;
+    out << "\nSuggestions for \"" << text << "\":\n";
+    for (auto b : results)
+        out << "[" << b->getBookId() << "] " << b->getTitle() << " - " << b->getAuthor()
+            << " (" << statusToString(b->getStatus()) << ", borrowed " << b->getBorrowCount() << " times)\n";
+    if (results.empty())
+        out << "No matching books found.\n";
+    writePage(out.str());
+}
+
+void LibraryConsole::displayBooks() {
+    int token = 0;
+    while (true) {
+        Page<Book *> page = lib.listBooks(token, pageSize);
+        ostringstream out;
+        for (auto b : page.items) {
+            b->printDetails(out);
+            out << "---------------------\n";
+        }
+        writePage(out.str());
+        token = page.nextToken;
+        if (!page.hasMore || !continuePaging())
+            break;
+    }
+}
+
+void LibraryConsole::borrowBook(User *user, int bookId, long long currentTime) {
+    printBorrowOutcome(user, bookId, lib.borrowBook(user, bookId, currentTime));
+}
+
+void LibraryConsole::borrowByIsbn(User *user, const string &isbn, long long currentTime) {
+    int bookId;
+    OpStatus status = lib.borrowBookByIsbn(user, isbn, currentTime, bookId);
+    if (status == OP_OK)
+        cout << "Copy " << bookId << ": ";
+    printBorrowOutcome(user, bookId, status);
+}
+
+void LibraryConsole::findByIsbn(const string &isbn) {
+    if (isbnKey(isbn) == 0) {
+        cout << opStatusToString(OP_INVALID_ISBN) << endl;
+        return;
+    }
+    vector<Book *> copies = lib.findBooksByIsbn(isbn);
+    if (!copies.empty())
+        cout << "Copies with ISBN " << formatIsbn(isbnKey(isbn)) << " (" << copies.size() << "):" << endl;
+    printBookList(copies);
+}
+
+void LibraryConsole::returnBook(User *user, int bookId, long long returnTime) {
+    ReturnResult result = lib.returnBook(user, bookId, returnTime);
+    if (result.status == OP_OK) {
+        if (result.overdueDays > 0)
+            cout << "Book was overdue by " << result.overdueDays << " days. Fine incurred: "
+                 << result.fineCharged << endl;
+        cout << user->getName() << " returned book: " << lib.findBook(bookId)->getTitle() << endl;
+    } else if (result.status == OP_NOT_BORROWED) {
+        cout << "No record found for this book in your borrowed list." << endl;
+    } else {
+        cout << opStatusToString(result.status) << endl;
+    }
+}
+
+// Book-drop processing: reads (user ID, book ID) pairs until a user ID of 0 and
+// returns them all in one batch.
+void LibraryConsole::returnMany(long long returnTime) {
+    cout << "Enter user ID and book ID for each returned book (0 to finish):" << endl;
+    vector<LoanRequest> items;
+    int userId, bookId;
+    while (cin >> userId && userId != 0 && cin >> bookId)
+        items.push_back({userId, bookId});
+    vector<ReturnResult> results = lib.returnMany(items, returnTime);
+    int returned = 0;
+    for (size_t i = 0; i < items.size(); i++) {
+        cout << "User " << items[i].userId << ", book " << items[i].bookId << ": ";
+        if (results[i].status == OP_OK) {
+            returned++;
+            cout << "Returned";
+            if (results[i].overdueDays > 0)
+                cout << " (overdue by " << results[i].overdueDays << " days, fine "
+                     << results[i].fineCharged << ")";
+            cout << endl;
+        } else {
+            cout << opStatusToString(results[i].status) << endl;
+        }
+    }
+    cout << returned << " of " << items.size() << " books returned." << endl;
+}
+
+void LibraryConsole::payFine(User *user) {
+    if (!user) {
+        cout << opStatusToString(OP_INVALID_USER) << endl;
+        return;
+    }
+    cout << "Fine before payment: " << user->getAccount().getFine() << endl;
+    double paid;
+    lib.payFine(user, paid);
+    cout << "Fine paid. Current fine: " << user->getAccount().getFine() << endl;
+}
+
+void LibraryConsole::displayUsers() {
+    int token = 0;
+    while (true) {
+        Page<User *> page = lib.listUsers(token, pageSize);
+        ostringstream out;
+        for (auto u : page.items) {
+            u->printDetails(out);
+            out << "Current borrowed books: " << u->getAccount().getBorrowedCount() << "\n";
+            out << "Outstanding fine: " << u->getAccount().getFine() << "\n";
+            out << "---------------------\n";
+        }
+        writePage(out.str());
+        token = page.nextToken;
+        if (!page.hasMore || !continuePaging())
+            break;
+    }
+}
+
+void LibraryConsole::displayFullBorrowHistory(User *user) {
+    const auto &currentBorrows = user->getAccount().getBorrowedBooks();
+    if (!currentBorrows.empty()) {
+        cout << endl << "Currently Borrowed Books:" << endl;
+        for (const auto &bb : currentBorrows) {
+            Book *book = lib.findBook(bb.bookId);
+            if (book) {
+                cout << "Book ID: " << bb.bookId << " - " << book->getTitle()
+                     << " | Borrowed at: " << bb.borrowTime << endl;
+            }
+        }
+    } else {
+        cout << endl << "No books are currently borrowed." << endl;
+    }
+    Page<BorrowHistory> page = lib.listHistory(user, 0, pageSize);
+    if (page.items.empty()) {
+        cout << endl << "No past borrowing history found." << endl;
+        return;
+    }
+    cout << endl << "Past Borrowing History:" << endl;
+    while (true) {
+        ostringstream out;
+        for (const auto &h : page.items) {
+            Book *book = lib.findBook(h.bookId);
+            if (book) {
+                out << "Book ID: " << h.bookId << " - " << book->getTitle()
+                    << " | Borrowed at: " << h.borrowTime
+                    << " | Returned at: " << h.returnTime
+                    << " | Overdue Days: " << h.overdueDays
+                    << " | Fine Charged: " << h.fineCharged << "\n";
+            }
+        }
+        writePage(out.str());
+        if (!page.hasMore || !continuePaging())
+            break;
+        page = lib.listHistory(user, page.nextToken, pageSize);
+    }
+}
+
+void LibraryConsole::addNewUser() {
+    cin.ignore();
+    cout << "Enter user type (Student, Faculty, Librarian): " << endl;
+    string type;
+    getline(cin, type);
+
+    cout << "Enter name: " << endl;
+    string name;
+    getline(cin, name);
+
+    cout << "Enter username: " << endl;
+    string uname;
+    getline(cin, uname);
+
+    cout << "Enter password: " << endl;
+    string pwd;
+    getline(cin, pwd);
+    addNewUser(type, name, uname, pwd);
+}
+
+void LibraryConsole::addNewUser(const string &type, const string &name, const string &uname, const string &pwd) {
+    User *newUser = lib.addNewUser(type, name, uname, pwd);
+    if (newUser)
+        cout << "Added " << newUser->getRole() << ": " << newUser->getName() << endl;
+    else
+        cout << opStatusToString(OP_INVALID_USER_TYPE) << endl;
+}
+
+void LibraryConsole::removeUser(int userId) {
+    User *user = lib.findUser(userId);
+    if (!user) {
+        cout << "User with ID " << userId << " not found." << endl;
+        return;
+    }
+    cout << "Removing user: " << user->getName() << endl;
+    lib.removeUser(userId);
+}
+
+void LibraryConsole::updateProfile(User *user) {
+    cin.ignore();
+    cout << "Enter new name (or press enter to keep current name (" << user->getName() << ")): " << endl;
+    string newName;
+    getline(cin, newName);
+    cout << "Enter new password (or press enter to keep current password): " << endl;
+    string newPwd;
+    getline(cin, newPwd);
+    updateProfile(user, newName, newPwd);
+}
+
+void LibraryConsole::updateProfile(User *user, const string &newName, const string &newPwd) {
+    user->updateProfile(newName, newPwd);
+    cout << "Profile updated successfully." << endl;
+}
+
+void LibraryConsole::overdueReport(long long currentTime, int days) {
+    const DueDateIndex &dueIndex = lib.getDueIndex();
+    vector<DueEntry> overdue = dueIndex.overdueAsOf(currentTime);
+    cout << endl << "Overdue Items (" << overdue.size() << "):" << endl;
+    for (const auto &e : overdue) {
+        Book *book = lib.findBook(e.bookId);
+        User *user = lib.findUser(e.userId);
+        cout << "Book ID: " << e.bookId << " - " << (book ? book->getTitle() : "(unknown)")
+             << " | User: " << e.userId << " " << (user ? user->getName() : "(unknown)")
+             << " | Overdue by: " << (currentTime - e.dueTime) / (24 * 60) << " days" << endl;
+    }
+    long long windowEnd = currentTime + static_cast<long long>(days) * 24 * 60;
+    vector<DueEntry> upcoming = dueIndex.dueBetween(currentTime, windowEnd);
+    cout << endl << "Due in the next " << days << " days (" << upcoming.size() << "):" << endl;
+    for (const auto &e : upcoming) {
+        Book *book = lib.findBook(e.bookId);
+        User *user = lib.findUser(e.userId);
+        cout << "Book ID: " << e.bookId << " - " << (book ? book->getTitle() : "(unknown)")
+             << " | User: " << e.userId << " " << (user ? user->getName() : "(unknown)")
+             << " | Due in: " << (e.dueTime - currentTime) / (24 * 60) << " days" << endl;
+    }
+}
+
+void LibraryConsole::fineAccrualReport(long long currentTime) {
+    LoanColumns loans;
+    lib.collectOpenLoans(loans);
+    AccrualResult result;
+    computeAccruals(loans, currentTime, result);
+    cout << endl << "Projected Fines on Open Loans:" << endl;
+    // Loans are collected user by user, so each user's loans form one run.
+    size_t i = 0;
+    while (i < loans.size()) {
+        int userId = loans.userIds[i];
+        long long userFine = 0;
+        int userOverdue = 0;
+        for (; i < loans.size() && loans.userIds[i] == userId; i++) {
+            userFine += result.projectedFines[i];
+            userOverdue += result.overdueDays[i] > 0;
+        }
+        if (userOverdue == 0) continue;
+        User *user = lib.findUser(userId);
+        cout << "User ID: " << userId << " " << (user ? user->getName() : "(unknown)")
+             << " | Overdue loans: " << userOverdue
+             << " | Projected fine: " << userFine << endl;
+    }
+    cout << "Open loans: " << loans.size() << " | Overdue: " << result.overdueLoans
+         << " | Total projected fines: " << result.totalFine << endl;
+}
+
+void LibraryConsole::showBorrower(int bookId) {
+    Book *book = lib.findBook(bookId);
+    if (!book) {
+        cout << opStatusToString(OP_BOOK_NOT_FOUND) << endl;
+        return;
+    }
+    const LoanEntry *loan = lib.findLoan(bookId);
+    if (loan) {
+        User *user = lib.findUser(loan->userId);
+        cout << "Book \"" << book->getTitle() << "\" is borrowed by user " << loan->userId << " "
+             << (user ? user->getName() : "(unknown)") << " | Borrowed at: " << loan->borrowTime << endl;
+    } else {
+        cout << "Book \"" << book->getTitle() << "\" is not on loan (" << statusToString(book->getStatus())
+             << ")." << endl;
+    }
+    vector<Hold> queue = lib.getHoldQueue(bookId);
+    if (!queue.empty())
+        cout << "Hold queue: " << queue.size() << " patron(s); next is user " << queue.front().userId << endl;
+}
+
+void LibraryConsole::consistencyReport() {
+    vector<string> problems = lib.checkConsistency();
+    if (problems.empty()) {
+        cout << "Loan records and reports are consistent." << endl;
+        return;
+    }
+    cout << "Consistency problems (" << problems.size() << "):" << endl;
+    for (const auto &problem : problems)
+        cout << "  " << problem << endl;
+}
+
+void LibraryConsole::pagingReport() {
+    PagingStats stats = lib.getPagingStats();
+    long long lookups = stats.hits + stats.faults;
+    cout << "Account paging: " << stats.residentUsers << " resident (~"
+         << stats.residentBytes / 1024 << " KiB), " << stats.pagedUsers << " paged out (~"
+         << stats.pageIndexBytes / 1024 << " KiB of index)" << endl;
+    cout << "Lookups: " << stats.hits << " hits, " << stats.faults << " faults";
+    if (lookups > 0)
+        cout << " (hit rate " << 100.0 * stats.hits / lookups << "%)";
+    cout << ", " << stats.evictions << " evictions" << endl;
+}
+
+void LibraryConsole::searchCacheReport() {
+    SearchCacheStats stats = lib.getSearchCacheStats();
+    long long lookups = stats.hits + stats.misses;
+    cout << "Search cache: " << stats.entries << " of " << stats.capacity << " entries" << endl;
+    cout << "Lookups: " << stats.hits << " hits, " << stats.misses << " misses";
+    if (lookups > 0)
+        cout << " (hit rate " << 100.0 * stats.hits / lookups << "%)";
+    cout << ", " << stats.stale << " stale, " << stats.evictions << " evictions" << endl;
+}
+
+void LibraryConsole::circulationReport() {
+    CirculationReport report = lib.getCirculationReport(10);
+    cout << endl << "Circulation Report:" << endl;
+    cout << "Outstanding fines: " << report.fineCents / 100.0 << " owed by " << report.usersWithFines
+         << " user(s)" << endl;
+    cout << "Open loans: " << report.openLoans;
+    for (const auto &entry : report.loansByRole)
+        cout << " | " << entry.first << ": " << entry.second;
+    cout << endl;
+    cout << "Reserved books: " << report.reservedBooks << " (" << report.waitingPatrons
+         << " patrons in hold queues)" << endl;
+    cout << "Most borrowed this month:" << endl;
+    if (report.mostBorrowed.empty())
+        cout << "  (no loans yet)" << endl;
+    int rank = 1;
+    for (const auto &entry : report.mostBorrowed)
+        cout << "  " << rank++ << ". " << entry.first->getTitle() << " (ID " << entry.first->getBookId()
+             << "): " << entry.second << " loan(s)" << endl;
+}
+
+static void printPeriod(const string &label, const PeriodTotals &p) {
+    cout << "  " << label << ": " << p.borrows << " borrowed, " << p.returns << " returned";
+    if (p.returns > 0)
+        cout << ", average loan " << p.loanMinutes / (24.0 * 60) / p.returns << " days, "
+             << 100.0 * p.lateReturns / p.returns << "% late";
+    cout << ", fines " << p.fineCents / 100.0 << endl;
+}
+
+// Summarises the whole borrowing history; the last few weeks are listed.
+void LibraryConsole::circulationAnalytics(int weeks) {
+    HistoryAnalytics result;
+    lib.analyzeCirculation(result);
+    cout << endl << "Circulation Analytics: " << result.records << " completed loans (" << result.threads
+         << " thread(s), " << result.seconds * 1000 << " ms)" << endl;
+    if (result.records == 0)
+        return;
+    printPeriod("All loans", result.total);
+    cout << "By role:" << endl;
+    for (size_t r = 0; r < result.roles.size(); r++) {
+        if (result.roles[r].returns > 0)
+            printPeriod(result.roleNames[r], result.roles[r]);
+    }
+    cout << "By week:" << endl;
+    size_t first = result.weeks.size() > static_cast<size_t>(weeks) ? result.weeks.size() - weeks : 0;
+    for (size_t w = first; w < result.weeks.size(); w++) {
+        // Weeks start on Monday; day 0 (1970-01-01) was a Thursday.
+        long long monday = (result.firstWeek + static_cast<long long>(w)) * 7 - 3;
+        printPeriod("Week of " + formatDate(monday * 24 * 60), result.weeks[w]);
+    }
+    size_t busiest = 0;
+    for (size_t d = 1; d < result.days.size(); d++) {
+        if (result.days[d].borrows > result.days[busiest].borrows)
+            busiest = d;
+    }
+    cout << "Busiest day: " << formatDate((result.firstDay + static_cast<long long>(busiest)) * 24 * 60) << " ("
+         << result.days[busiest].borrows << " borrowed)" << endl;
+}
+
+void LibraryConsole::printBorrowOutcome(User *user, int bookId, OpStatus status) {
+    if (status == OP_OK)
+        cout << user->getName() << " borrowed book: " << lib.findBook(bookId)->getTitle() << endl;
+    else if (status == OP_FINE_OUTSTANDING)
+        cout << "Outstanding fine: " << user->getAccount().getFine()
+             << ". Please clear your fine before borrowing." << endl;
+    else
+        cout << opStatusToString(status) << endl;
+}
+
+// Advanced search results arrive already sorted, so they are paged in memory
+// rather than through a Library cursor.
+void LibraryConsole::printBookList(const vector<Book *> &results) {
+    if (results.empty()) {
+        cout << "No matching books found." << endl;
+        return;
+    }
+    size_t start = 0;
+    while (true) {
+        size_t end = min(results.size(), start + pageSize);
+        ostringstream out;
+        for (size_t i = start; i < end; i++) {
+            results[i]->printDetails(out);
+            out << "---------------------\n";
+        }
+        writePage(out.str());
+        start = end;
+        if (start >= results.size() || !continuePaging())
+            break;
+    }
+}
+
+void LibraryConsole::writePage(const string &text) {
+    cout.write(text.data(), text.size());
+    cout.flush();
+}
+
+bool LibraryConsole::continuePaging() {
+    if (!prompting)
+        return true;
+    cout << "Show more? (y/n): " << flush;
+    char reply;
+    if (!(cin >> reply))
+        return false;
+    return reply == 'y' || reply == 'Y';
+}
@@ -0,0 +1,81 @@
+/*
+ * LibraryConsole.h
+ *
+ * This file declares the LibraryConsole class, the interactive text front end
+ * built on top of the Library API. It prompts for input where needed, calls
+ * the corresponding Library operation and prints the outcome, so the Library
+ * itself never touches cin or cout.
+ *
+ * Listings (books, users, search results and history) are fetched from the
+ * Library one page at a time. Each page is formatted into a buffer and
+ * written in one go; between pages the user is asked whether to continue,
+ * unless prompting has been turned off (as in batch mode).
+ */
+
+#ifndef LIBRARYCONSOLE_H
+#define LIBRARYCONSOLE_H
+
+#include "Library.h"
+#include <string>
+#include <vector>
+using namespace std;
+
+class LibraryConsole {
+public:
+    explicit LibraryConsole(Library &lib);
+
+    void setPageSize(int size);
+    void setPrompting(bool enabled);
+
+    void addUser(User *user);
+    void checkOverdueNotifications(User *user, long long currentTime);
+    void renewBook(User *user, int bookId, long long currentTime);
+    void cancelReservation(User *user, int bookId);
+    void advancedSearchBooks();
+    void advancedSearchBooks(const string &term, int yearFilter, int availFilter, int sortOption, bool fuzzy);
+    void addBook(const string &title, const string &author,
+                 const string &publisher, int year, const string &isbn);
+    void importCatalog(const string &path);
+    void removeBook(int bookId);
+    void updateBookDetails(int bookId);
+    void updateBookDetails(int bookId, const string &title, const string &author,
+                           const string &publisher, int year, const string &isbn);
+    void reserveBook(User *user, int bookId, long long currentTime);
+    void borrowReservedBook(User *user, int bookId, long long currentTime);
+    void searchBooks(const string &term);
+    void autocomplete(const string &text);
+    void displayBooks();
+    void borrowBook(User *user, int bookId, long long currentTime);
+    void borrowByIsbn(User *user, const string &isbn, long long currentTime);
+    void findByIsbn(const string &isbn);
+    void returnBook(User *user, int bookId, long long returnTime);
+    void returnMany(long long returnTime);
+    void payFine(User *user);
+    void displayUsers();
+    void displayFullBorrowHistory(User *user);
+    void addNewUser();
+    void addNewUser(const string &type, const string &name, const string &uname, const string &pwd);
+    void removeUser(int userId);
+    void updateProfile(User *user);
+    void updateProfile(User *user, const string &newName, const string &newPwd);
+    void overdueReport(long long currentTime, int days);
+    void fineAccrualReport(long long currentTime);
+    void showBorrower(int bookId);
+    void consistencyReport();
+    void pagingReport();
+    void searchCacheReport();
+    void circulationReport();
+    void circulationAnalytics(int weeks = 12);
+
+private:
+    void printBorrowOutcome(User *user, int bookId, OpStatus status);
+    void printBookList(const vector<Book *> &results);
+    void writePage(const string &text);
+    bool continuePaging();
+
+    Library &lib;
+    int pageSize;
+    bool prompting;
+};
+
+#endif
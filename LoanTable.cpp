@@ -0,0 +1,42 @@
+/*
+ * LoanTable.cpp
+ *
+ * This file implements the LoanTable class declared in LoanTable.h.
+ */
+
+#include "LoanTable.h"
+using namespace std;
+
+// A book can only be out once, so a new loan replaces any earlier entry.
+void LoanTable::add(int bookId, int userId, long long borrowTime) {
+    byBook[bookId] = {userId, borrowTime};
+}
+
+bool LoanTable::renew(int bookId, long long borrowTime) {
+    auto it = byBook.find(bookId);
+    if (it == byBook.end()) return false;
+    it->second.borrowTime = borrowTime;
+    return true;
+}
+
+bool LoanTable::remove(int bookId) {
+    return byBook.erase(bookId) != 0;
+}
+
+void LoanTable::clear() {
+    byBook.clear();
+}
+
+// Returns nullptr if the book is not on loan.
+const LoanEntry *LoanTable::find(int bookId) const {
+    auto it = byBook.find(bookId);
+    return it == byBook.end() ? nullptr : &it->second;
+}
+
+size_t LoanTable::size() const {
+    return byBook.size();
+}
+
+const unordered_map<int, LoanEntry> &LoanTable::entries() const {
+    return byBook;
+}
@@ -0,0 +1,42 @@
+/*
+ * LoanTable.h
+ *
+ * This file declares the LoanTable class, the library-wide reverse index of
+ * open loans: for each book that is out, the user holding it and when it was
+ * borrowed.
+ *
+ * Accounts list the loans of one user; the LoanTable answers the opposite
+ * question ("who has this copy?") in O(1). The Library keeps it in step on
+ * every borrow, renewal and return, uses it to close a book's loan when the
+ * book is removed, and checks it against the accounts, the book statuses and
+ * the due-date index in checkConsistency().
+ */
+
+#ifndef LOANTABLE_H
+#define LOANTABLE_H
+
+#include <cstddef>
+#include <unordered_map>
+using namespace std;
+
+struct LoanEntry {
+    int userId;
+    long long borrowTime;
+};
+
+class LoanTable {
+public:
+    void add(int bookId, int userId, long long borrowTime);
+    bool renew(int bookId, long long borrowTime);
+    bool remove(int bookId);
+    void clear();
+
+    const LoanEntry *find(int bookId) const;
+    size_t size() const;
+    const unordered_map<int, LoanEntry> &entries() const;
+
+private:
+    unordered_map<int, LoanEntry> byBook;
+};
+
+#endif
@@ -0,0 +1,248 @@
+/*
+ * PrefixIndex.cpp
+ *
+ * This file implements the PrefixIndex class declared in PrefixIndex.h.
+ */
+
+#include "PrefixIndex.h"
+#include "TextFold.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+using namespace std;
+
+// Runs of letters and digits, after folding case and accents (see
+// TextFold.h). Bytes outside ASCII that survive folding are kept as they
+// are, so words in other scripts still index as words.
+vector<string> PrefixIndex::tokenize(string_view text) {
+    return split(foldText(text));
+}
+
+vector<string> PrefixIndex::split(string_view folded) {
+    vector<string> words;
+    string word;
+    for (char ch : folded) {
+        unsigned char c = static_cast<unsigned char>(ch);
+        if (isalnum(c) || c >= 0x80) {
+            word += ch;
+        } else if (!word.empty()) {
+            words.push_back(word);
+            word.clear();
+        }
+    }
+    if (!word.empty())
+        words.push_back(word);
+    return words;
+}
+
+// A word repeated in the title or author is indexed once per book. The
+// book's search key is already folded.
+vector<string> PrefixIndex::wordsOf(Book *book) {
+    vector<string> words = split(book->getSearchKey());
+    sort(words.begin(), words.end());
+    words.erase(unique(words.begin(), words.end()), words.end());
+    return words;
+}
+
+namespace {
+
+bool idLess(Book *a, Book *b) {
+    return a->getBookId() < b->getBookId();
+}
+
+// Most borrowed first, ties by ID.
+bool moreBorrowed(Book *a, Book *b) {
+    if (a->getBorrowCount() != b->getBorrowCount())
+        return a->getBorrowCount() > b->getBorrowCount();
+    return a->getBookId() < b->getBookId();
+}
+
+}
+
+// Each word's books are kept in ID order, so removing one is a binary search
+// and books added in ID order are appended.
+void PrefixIndex::add(Book *book) {
+    for (string &word : wordsOf(book)) {
+        auto posting = postings.find(word);
+        if (posting == postings.end()) {
+            words.insert(word);
+            posting = postings.emplace(move(word), vector<Book *>()).first;
+        }
+        vector<Book *> &books = posting->second;
+        if (books.empty() || idLess(books.back(), book))
+            books.push_back(book);
+        else
+            books.insert(upper_bound(books.begin(), books.end(), book, idLess), book);
+        entries++;
+    }
+}
+
+// Indexes many books at once, such as a whole catalog on load or an
+// imported feed. The (word, book) pairs are sorted first, so each distinct
+// word is looked up in the dictionary once and in order, instead of once per
+// book in random order.
+void PrefixIndex::addAll(const vector<Book *> &books) {
+    vector<Book *> byId(books);
+    if (!is_sorted(byId.begin(), byId.end(), idLess))
+        sort(byId.begin(), byId.end(), idLess);
+    vector<pair<string, Book *>> pairs;
+    pairs.reserve(byId.size() * 6);
+    for (Book *book : byId) {
+        for (string &word : wordsOf(book))
+            pairs.emplace_back(move(word), book);
+    }
+    // Stable, so each word's books stay in ID order.
+    stable_sort(pairs.begin(), pairs.end(), [](const pair<string, Book *> &a, const pair<string, Book *> &b) {
+        return a.first < b.first;
+    });
+    auto hint = postings.begin();
+    for (size_t i = 0; i < pairs.size();) {
+        const string &word = pairs[i].first;
+        hint = postings.lower_bound(word);
+        if (hint == postings.end() || hint->first != word) {
+            words.insert(word);
+            hint = postings.emplace_hint(hint, word, vector<Book *>());
+        }
+        vector<Book *> &posting = hint->second;
+        size_t old = posting.size();
+        for (; i < pairs.size() && pairs[i].first == word; i++)
+            posting.push_back(pairs[i].second);
+        entries += posting.size() - old;
+        if (old > 0 && idLess(posting[old], posting[old - 1]))
+            inplace_merge(posting.begin(), posting.begin() + old, posting.end(), idLess);
+    }
+}
+
+// Must be called while the book still has the title and author it was
+// indexed under.
+void PrefixIndex::remove(Book *book) {
+    for (const string &word : wordsOf(book)) {
+        auto posting = postings.find(word);
+        if (posting == postings.end())
+            continue;
+        vector<Book *> &books = posting->second;
+        auto it = lower_bound(books.begin(), books.end(), book, idLess);
+        if (it == books.end() || *it != book)
+            continue;
+        books.erase(it);
+        entries--;
+        if (books.empty())
+            postings.erase(posting);
+    }
+}
+
+void PrefixIndex::clear() {
+    postings.clear();
+    words.clear();
+    entries = 0;
+}
+
+// The words starting with prefix occupy [first, last) of the dictionary.
+pair<PrefixIndex::WordIterator, PrefixIndex::WordIterator>
+PrefixIndex::wordsStartingWith(const string &prefix) const {
+    WordIterator first = postings.lower_bound(prefix), last = first;
+    while (last != postings.end() && last->first.compare(0, prefix.size(), prefix) == 0)
+        ++last;
+    return make_pair(first, last);
+}
+
+// Up to limit books, most borrowed first (ties by ID).
+vector<Book *> PrefixIndex::complete(const string &text, size_t limit) const {
+    vector<Book *> results;
+    vector<string> words = tokenize(text);
+    if (words.empty() || limit == 0)
+        return results;
+
+    // The run holding the fewest books drives the search.
+    size_t driver = 0, driverBooks = 0;
+    pair<WordIterator, WordIterator> best;
+    for (size_t i = 0; i < words.size(); i++) {
+        auto run = wordsStartingWith(words[i]);
+        size_t books = 0;
+        for (auto it = run.first; it != run.second; ++it)
+            books += it->second.size();
+        if (i == 0 || books < driverBooks) {
+            best = run;
+            driver = i;
+            driverBooks = books;
+        }
+        if (books == 0)
+            return results;
+    }
+
+    // results is a heap with the weakest of the current top entries at the
+    // front. A book holding several words of the run is offered once per
+    // word, so it is only added if it is not already there.
+    auto matchesOtherWords = [&](Book *book) {
+        if (words.size() == 1)
+            return true;
+        vector<string> bookWords = wordsOf(book);
+        for (size_t i = 0; i < words.size(); i++) {
+            if (i == driver) continue;
+            auto w = lower_bound(bookWords.begin(), bookWords.end(), words[i]);
+            if (w == bookWords.end() || w->compare(0, words[i].size(), words[i]) != 0)
+                return false;
+        }
+        return true;
+    };
+    for (auto word = best.first; word != best.second; ++word) {
+        for (Book *book : word->second) {
+            if (results.size() == limit && !moreBorrowed(book, results.front()))
+                continue;
+            if (find(results.begin(), results.end(), book) != results.end() || !matchesOtherWords(book))
+                continue;
+            if (results.size() == limit) {
+                pop_heap(results.begin(), results.end(), moreBorrowed);
+                results.back() = book;
+            } else {
+                results.push_back(book);
+            }
+            push_heap(results.begin(), results.end(), moreBorrowed);
+        }
+    }
+    sort_heap(results.begin(), results.end(), moreBorrowed);
+    return results;
+}
+
+int PrefixIndex::allowedEdits(size_t wordLength) {
+    if (wordLength <= 2) return 0;
+    if (wordLength <= 5) return 1;
+    return 2;
+}
+
+// Books in ID order where every typed word is within allowedEdits of some
+// word of the title or author.
+vector<Book *> PrefixIndex::fuzzyMatch(const string &text) const {
+    vector<Book *> results;
+    vector<string> typed = tokenize(text);
+    for (size_t i = 0; i < typed.size(); i++) {
+        vector<Book *> matches;
+        for (const string &word : words.find(typed[i], allowedEdits(typed[i].size()))) {
+            auto posting = postings.find(word);
+            if (posting != postings.end())
+                matches.insert(matches.end(), posting->second.begin(), posting->second.end());
+        }
+        sort(matches.begin(), matches.end(), idLess);
+        matches.erase(unique(matches.begin(), matches.end()), matches.end());
+        if (i == 0) {
+            results.swap(matches);
+        } else {
+            vector<Book *> both;
+            set_intersection(results.begin(), results.end(), matches.begin(), matches.end(),
+                             back_inserter(both), idLess);
+            results.swap(both);
+        }
+        if (results.empty())
+            break;
+    }
+    return results;
+}
+
+// Number of (word, book) pairs indexed.
+size_t PrefixIndex::size() const {
+    return entries;
+}
+
+size_t PrefixIndex::wordCount() const {
+    return postings.size();
+}
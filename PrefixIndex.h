@@ -0,0 +1,68 @@
+/*
+ * PrefixIndex.h
+ *
+ * This file declares the PrefixIndex class, which completes the first few
+ * letters typed at a search kiosk into matching books.
+ *
+ * Every word of every title and author is normalised (case and accents
+ * folded, split on anything that is not a letter or digit) and kept in a
+ * sorted dictionary from word to the books containing it, so the words
+ * starting with a prefix are one contiguous run of the dictionary, found in
+ * O(log words). Books in that run are ranked by how often they have been
+ * borrowed, keeping only the current top N while scanning, so a query never
+ * sorts the whole run. When several words are typed, each must begin some
+ * word of the book, and the run holding the fewest books drives the search.
+ *
+ * The same words are also kept in a BK-tree for typo-tolerant search: each
+ * typed word may be a few edits away from a word of the book (none for one
+ * or two letters, one for up to five, two beyond that).
+ *
+ * The Library adds a book's words when it is added and removes them before
+ * the book is removed or its details change, so the index never needs a full
+ * rebuild after loading. The catalog loaded at startup and imported feeds are
+ * added with addAll, which sorts their words first.
+ */
+
+#ifndef PREFIXINDEX_H
+#define PREFIXINDEX_H
+
+#include "BKTree.h"
+#include "Book.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+using namespace std;
+
+class PrefixIndex {
+public:
+    PrefixIndex() : entries(0) {}
+
+    void add(Book *book);
+    void addAll(const vector<Book *> &books);
+    void remove(Book *book);
+    void clear();
+
+    vector<Book *> complete(const string &text, size_t limit) const;
+    vector<Book *> fuzzyMatch(const string &text) const;
+    size_t size() const;
+    size_t wordCount() const;
+
+    static vector<string> tokenize(string_view text);
+    static int allowedEdits(size_t wordLength);
+
+private:
+    typedef map<string, vector<Book *>>::const_iterator WordIterator;
+
+    static vector<string> split(string_view folded);
+    static vector<string> wordsOf(Book *book);
+    pair<WordIterator, WordIterator> wordsStartingWith(const string &prefix) const;
+
+    map<string, vector<Book *>> postings;
+    BKTree words;
+    size_t entries;
+};
+
+#endif
@@ -0,0 +1,89 @@
+/*
+ * ReservationWheel.cpp
+ *
+ * This file implements the hierarchical timing wheel declared in ReservationWheel.h.
+ * Slots are indexed by the absolute deadline, so an entry placed on level L fires
+ * (or is cascaded to a lower level) exactly when the wheel reaches the start of
+ * its level-L period.
+ */
+
+#include "ReservationWheel.h"
+using namespace std;
+
+ReservationWheel::ReservationWheel() : currentTick(0), count(0) {}
+
+void ReservationWheel::reset(long long now) {
+    for (int level = 0; level < LEVELS; level++)
+        for (int slot = 0; slot < SLOTS; slot++)
+            slots[level][slot].clear();
+    overflow.clear();
+    ready.clear();
+    currentTick = now;
+    count = 0;
+}
+
+void ReservationWheel::schedule(int bookId, long long deadline) {
+    place({bookId, deadline});
+    count++;
+}
+
+void ReservationWheel::place(const WheelEntry &entry) {
+    long long delta = entry.deadline - currentTick;
+    if (delta <= 0) {
+        ready.push_back(entry);
+        return;
+    }
+    for (int level = 0; level < LEVELS; level++) {
+        if (delta < (1LL << (BITS * (level + 1)))) {
+            int slot = static_cast<int>((entry.deadline >> (BITS * level)) & (SLOTS - 1));
+            slots[level][slot].push_back(entry);
+            return;
+        }
+    }
+    overflow.push_back(entry);
+}
+
+void ReservationWheel::advance(long long now, vector<WheelEntry> &due) {
+    if (!ready.empty()) {
+        count -= ready.size();
+        due.insert(due.end(), ready.begin(), ready.end());
+        ready.clear();
+    }
+    while (currentTick < now) {
+        if (count == 0) {
+            currentTick = now;
+            break;
+        }
+        currentTick++;
+        if ((currentTick & ((1LL << (BITS * LEVELS)) - 1)) == 0) {
+            vector<WheelEntry> pending;
+            pending.swap(overflow);
+            for (const auto &e : pending)
+                place(e);
+        }
+        for (int level = LEVELS - 1; level > 0; level--) {
+            if ((currentTick & ((1LL << (BITS * level)) - 1)) != 0)
+                continue;
+            int slot = static_cast<int>((currentTick >> (BITS * level)) & (SLOTS - 1));
+            vector<WheelEntry> pending;
+            pending.swap(slots[level][slot]);
+            for (const auto &e : pending)
+                place(e);
+        }
+        vector<WheelEntry> &expired = slots[0][currentTick & (SLOTS - 1)];
+        if (!expired.empty()) {
+            count -= expired.size();
+            due.insert(due.end(), expired.begin(), expired.end());
+            expired.clear();
+        }
+        if (!ready.empty()) {
+            count -= ready.size();
+            due.insert(due.end(), ready.begin(), ready.end());
+            ready.clear();
+        }
+    }
+}
+
+int ReservationWheel::size() const {
+    return count;
+}
@@ -0,0 +1,53 @@
+/*
+ * ReservationWheel.h
+ *
+ * This file declares the ReservationWheel class, a hierarchical timing wheel
+ * used to expire book reservations eagerly instead of waiting for the reserving
+ * user to come back for the book.
+ *
+ * Time is measured in minutes (the same unit as getCurrentTimeInMinutes()).
+ * The wheel has LEVELS levels of SLOTS slots each; level 0 has a resolution of
+ * one minute and every higher level covers SLOTS times the span of the level
+ * below it. Entries are moved down a level when their slot comes around, so
+ * scheduling is O(1) and advancing costs O(1) amortized per tick.
+ *
+ * Entries are never removed individually. When a reservation is cancelled or
+ * fulfilled, its entry stays in the wheel and is discarded by the caller when
+ * it fires (the deadline no longer matches the book's reservation).
+ */
+
+#ifndef RESERVATIONWHEEL_H
+#define RESERVATIONWHEEL_H
+
+#include <vector>
+using namespace std;
+
+struct WheelEntry {
+    int bookId;
+    long long deadline;
+};
+
+class ReservationWheel {
+public:
+    ReservationWheel();
+
+    void reset(long long now);
+    void schedule(int bookId, long long deadline);
+    void advance(long long now, vector<WheelEntry> &due);
+    int size() const;
+
+private:
+    static const int BITS = 6;
+    static const int SLOTS = 1 << BITS;
+    static const int LEVELS = 4;
+
+    void place(const WheelEntry &entry);
+
+    vector<WheelEntry> slots[LEVELS][SLOTS];
+    vector<WheelEntry> overflow;
+    vector<WheelEntry> ready;
+    long long currentTick;
+    int count;
+};
+
+#endif
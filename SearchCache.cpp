@@ -0,0 +1,76 @@
+/*
+ * SearchCache.cpp
+ *
+ * This file implements the SearchCache class declared in SearchCache.h.
+ */
+
+#include "SearchCache.h"
+#include <utility>
+using namespace std;
+
+SearchCache::SearchCache(size_t capacity)
+    : capacity(capacity), hits(0), misses(0), stale(0), evictions(0) {}
+
+// The results stored for key, or nullptr if there are none or they were
+// computed before the given versions. A hit moves the entry to the front.
+// The pointer stays valid until the next call to store.
+const vector<Book *> *SearchCache::find(const string &key, uint64_t catalogVersion, uint64_t statusVersion) {
+    auto pos = lruPos.find(key);
+    if (pos == lruPos.end()) {
+        misses++;
+        return nullptr;
+    }
+    const Entry &entry = *pos->second;
+    if (entry.catalogVersion != catalogVersion ||
+        (entry.dependsOnStatus && entry.statusVersion != statusVersion)) {
+        stale++;
+        misses++;
+        lru.erase(pos->second);
+        lruPos.erase(pos);
+        return nullptr;
+    }
+    hits++;
+    lru.splice(lru.begin(), lru, pos->second);
+    return &lru.front().results;
+}
+
+// Keeps results under key and returns them, evicting the least recently
+// used entry if the cache is full.
+const vector<Book *> &SearchCache::store(const string &key, vector<Book *> results, uint64_t catalogVersion,
+                                         uint64_t statusVersion, bool dependsOnStatus) {
+    if (capacity == 0) {
+        uncached = move(results);
+        return uncached;
+    }
+    auto pos = lruPos.find(key);
+    if (pos != lruPos.end()) {
+        lru.erase(pos->second);
+        lruPos.erase(pos);
+    }
+    evictTo(capacity - 1);
+    lru.push_front({key, move(results), catalogVersion, statusVersion, dependsOnStatus});
+    lruPos[key] = lru.begin();
+    return lru.front().results;
+}
+
+void SearchCache::setCapacity(size_t entries) {
+    capacity = entries;
+    evictTo(capacity);
+}
+
+void SearchCache::clear() {
+    lru.clear();
+    lruPos.clear();
+}
+
+SearchCacheStats SearchCache::stats() const {
+    return {hits, misses, stale, evictions, lru.size(), capacity};
+}
+
+void SearchCache::evictTo(size_t entries) {
+    while (lru.size() > entries) {
+        lruPos.erase(lru.back().key);
+        lru.pop_back();
+        evictions++;
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * SearchCache.h
+ *
+ * This file declares the SearchCache class, which keeps the results of
+ * recent searches so the popular queries repeated at the kiosks do not scan
+ * the whole catalog every time.
+ *
+ * Entries are keyed by the folded query together with its filters and kept
+ * in least-recently-used order; once the cache is full, storing a new entry
+ * evicts the one used longest ago. Rather than being cleared by every
+ * change, each entry records the catalog version it was computed at (bumped
+ * by the Library whenever books are added, removed or edited) and, if its
+ * results depend on circulation (an availability filter or sorting by
+ * popularity), the Library's status version too (bumped whenever it changes
+ * a book's status or borrow count). A
+ * lookup that finds an entry from an older version counts as stale, drops
+ * it and reports a miss, so results are never out of date.
+ *
+ * Capacity 0 turns caching off: every lookup misses and nothing is kept.
+ */
+
+#ifndef SEARCHCACHE_H
+#define SEARCHCACHE_H
+
+#include "Book.h"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+struct SearchCacheStats {
+    long long hits;
+    long long misses;
+    long long stale;
+    long long evictions;
+    size_t entries;
+    size_t capacity;
+};
+
+class SearchCache {
+public:
+    explicit SearchCache(size_t capacity = 256);
+
+    const vector<Book *> *find(const string &key, uint64_t catalogVersion, uint64_t statusVersion);
+    const vector<Book *> &store(const string &key, vector<Book *> results, uint64_t catalogVersion,
+                                uint64_t statusVersion, bool dependsOnStatus);
+    void setCapacity(size_t entries);
+    void clear();
+    SearchCacheStats stats() const;
+
+private:
+    struct Entry {
+        string key;
+        vector<Book *> results;
+        uint64_t catalogVersion;
+        uint64_t statusVersion;
+        bool dependsOnStatus;
+    };
+
+    void evictTo(size_t entries);
+
+    list<Entry> lru;
+    unordered_map<string, list<Entry>::iterator> lruPos;
+    vector<Book *> uncached;
+    size_t capacity;
+    long long hits;
+    long long misses;
+    long long stale;
+    long long evictions;
+};
+
+#endif
@@ -0,0 +1,591 @@
+/*
+ * Simulation.cpp
+ *
+ * This file implements the circulation simulator declared in Simulation.h.
+ * Each simulated day performs one operation per user on average, spread evenly
+ * over the day, so a run of N users over D days performs N * D operations.
+ */
+
+#include "Simulation.h"
+#include "Library.h"
+#include "Clock.h"
+#include "Utility.h"
+#include "Isbn.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+using namespace std;
+
+namespace {
+
+enum SimOp { SIM_BORROW, SIM_RETURN, SIM_RENEW, SIM_RESERVE, SIM_COLLECT, SIM_CANCEL, SIM_PAY, SIM_OP_COUNT };
+
+const char *simOpNames[SIM_OP_COUNT] = {
+    "borrow", "return", "renew", "reserve", "collect reserved", "cancel reservation", "pay fine"
+};
+
+// Made-up words of two to four syllables, so that titles share prefixes and
+// near-misses the way real ones do.
+vector<string> syntheticVocabulary(int words, mt19937 &rng) {
+    static const char *const syllables[] = {"ka", "lo", "mi", "ne", "ru", "sa", "ti", "vo", "ber", "dan",
+                                            "gor", "hel", "jin", "pra", "qua", "wes"};
+    const int syllableCount = sizeof(syllables) / sizeof(syllables[0]);
+    vector<string> vocabulary;
+    vocabulary.reserve(words);
+    for (int i = 0; i < words; i++) {
+        string word;
+        for (int n = 2 + rng() % 3; n > 0; n--)
+            word += syllables[rng() % syllableCount];
+        vocabulary.push_back(word);
+    }
+    return vocabulary;
+}
+
+// Adds books 1..bookCount, each titled with two to maxTitleWords words of
+// the vocabulary and with a two-word author.
+void addSyntheticCatalog(Library &lib, int bookCount, const vector<string> &vocabulary, int maxTitleWords,
+                         mt19937 &rng) {
+    cout << "Building a catalog of " << bookCount << " books..." << endl;
+    for (int b = 1; b <= bookCount; b++) {
+        string title = vocabulary[rng() % vocabulary.size()];
+        for (int n = 1 + rng() % (maxTitleWords - 1); n > 0; n--)
+            title += " " + vocabulary[rng() % vocabulary.size()];
+        string author = vocabulary[rng() % vocabulary.size()] + " " + vocabulary[rng() % vocabulary.size()];
+        lib.addBook(title, author, "Press", 2000, formatIsbn(completeIsbn(979000000000ULL + b)));
+    }
+}
+
+// The library most benchmarks start from: books 1..books titled "Bench
+// Title <n>", copiesPerTitle copies to a title, with an ISBN per title
+// unless isbns is false, and users 1..users, all faculty or all students.
+struct BenchLibrary {
+    int books;
+    int copiesPerTitle;
+    bool isbns;
+    int users;
+    bool faculty;
+};
+
+void addBenchLibrary(Library &lib, const BenchLibrary &spec) {
+    for (int b = 1; b <= spec.books; b++) {
+        int title = (b - 1) / spec.copiesPerTitle + 1;
+        lib.addBook("Bench Title " + to_string(title), "Author", "Press", 2000,
+                    spec.isbns ? formatIsbn(completeIsbn(979000000000ULL + title)) : "");
+    }
+    for (int i = 1; i <= spec.users; i++) {
+        if (spec.faculty)
+            lib.addUser(new Faculty(i, "Faculty " + to_string(i), "faculty" + to_string(i), "pwd", true));
+        else
+            lib.addUser(new Student(i, "Student " + to_string(i), "student" + to_string(i), "pwd", true));
+    }
+}
+
+}
+
+void runSimulation(int userCount, int bookCount, int days, unsigned seed) {
+    const long long startTime = 28000000;  // A fixed start keeps runs reproducible.
+    VirtualClock clock(startTime);
+    mt19937 rng(seed);
+    long long opCounts[SIM_OP_COUNT] = {0};
+    long long totalOps = 0;
+    double seconds = 0;
+    unsigned long long checksum = 0;
+    int openLoans = 0;
+    double outstandingFines = 0;
+
+    {
+        TransactionLogScope quiet(false);
+        Library lib;
+        lib.setClock(&clock);
+        vector<User *> population;
+        for (int i = 1; i <= bookCount; i++)
+            lib.addBook("Simulated Title " + to_string(i), "Author " + to_string(i % 500),
+                        "Sim Press", 1990 + static_cast<int>(i % 35), formatIsbn(completeIsbn(978000000000ULL + i)));
+        for (int i = 1; i <= userCount; i++) {
+            User *user;
+            if (i % 5 == 0)
+                user = new Faculty(i, "Faculty " + to_string(i), "faculty" + to_string(i), "pwd", true);
+            else
+                user = new Student(i, "Student " + to_string(i), "student" + to_string(i), "pwd", true);
+            lib.addUser(user);
+            population.push_back(user);
+        }
+        vector<vector<int>> reservations(userCount + 1);
+
+        auto start = chrono::steady_clock::now();
+        for (int day = 0; day < days; day++) {
+            long long dayStart = startTime + static_cast<long long>(day) * 24 * 60;
+            for (int i = 0; i < userCount; i++) {
+                clock.set(dayStart + static_cast<long long>(i) * 24 * 60 / userCount);
+                long long now = clock.nowInMinutes();
+                lib.expireReservations(now);
+                User *user = population[rng() % population.size()];
+                const vector<BorrowedBook> &loans = user->getAccount().getBorrowedBooks();
+                vector<int> &held = reservations[user->getUserId()];
+                int roll = rng() % 100;
+                SimOp op;
+                if (roll < 35) {
+                    op = SIM_BORROW;
+                    lib.borrowBook(user, 1 + rng() % bookCount, now);
+                } else if (roll < 65) {
+                    op = SIM_RETURN;
+                    if (!loans.empty())
+                        lib.returnBook(user, loans[rng() % loans.size()].bookId, now);
+                } else if (roll < 72) {
+                    op = SIM_RENEW;
+                    if (!loans.empty())
+                        lib.renewBook(user, loans[rng() % loans.size()].bookId, now);
+                } else if (roll < 82) {
+                    op = SIM_RESERVE;
+                    int bookId = 1 + rng() % bookCount;
+                    lib.reserveBook(user, bookId, now);
+                    held.push_back(bookId);
+                } else if (roll < 90) {
+                    op = SIM_COLLECT;
+                    if (!held.empty()) {
+                        lib.borrowReservedBook(user, held.back(), now);
+                        held.pop_back();
+                    }
+                } else if (roll < 94) {
+                    op = SIM_CANCEL;
+                    if (!held.empty()) {
+                        lib.cancelReservation(user, held.back());
+                        held.pop_back();
+                    }
+                } else {
+                    op = SIM_PAY;
+                    double paid;
+                    if (user->getAccount().getFineCents() > 0)
+                        lib.payFine(user, paid);
+                }
+                opCounts[op]++;
+                totalOps++;
+            }
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        checksum = lib.stateChecksum();
+        for (auto u : population) {
+            openLoans += u->getAccount().getBorrowedCount();
+            outstandingFines += u->getAccount().getFine();
+        }
+    }
+
+    cout << "Simulated " << days << " days with " << userCount << " users and "
+         << bookCount << " books (seed " << seed << ")" << endl;
+    for (int op = 0; op < SIM_OP_COUNT; op++)
+        cout << "  " << simOpNames[op] << ": " << opCounts[op] << endl;
+    cout << "Operations: " << totalOps << " in " << seconds << " s ("
+         << static_cast<long long>(seconds > 0 ? totalOps / seconds : 0) << " ops/sec)" << endl;
+    cout << "Open loans: " << openLoans << " | Outstanding fines: " << outstandingFines << endl;
+    cout << "State checksum: " << hex << checksum << dec << endl;
+}
+
+// Faculty members (five loans each, no fines) borrow every book once and then
+// return them all, first one call at a time and then through the bulk API.
+void benchmarkBulkCirculation(int loans) {
+    const string scratchLog = "bench_transactions.log";
+    const long long borrowTime = 28000000;
+    const long long returnTime = borrowTime + 24 * 60;
+    int userCount = (loans + 4) / 5;
+    TransactionLogScope log(true, scratchLog);
+
+    for (int bulk = 0; bulk < 2; bulk++) {
+        Library lib;
+        addBenchLibrary(lib, {loans, 1, true, userCount, true});
+        remove(scratchLog.c_str());
+
+        vector<LoanRequest> requests;
+        for (int i = 0; i < loans; i++)
+            requests.push_back({i / 5 + 1, i + 1});
+        int failures = 0;
+        auto start = chrono::steady_clock::now();
+        if (bulk) {
+            for (int u = 1; u <= userCount; u++) {
+                vector<int> bookIds;
+                for (int b = (u - 1) * 5 + 1; b <= min(loans, u * 5); b++)
+                    bookIds.push_back(b);
+                for (OpStatus s : lib.borrowMany(lib.findUser(u), bookIds, borrowTime))
+                    failures += s != OP_OK;
+            }
+        } else {
+            for (const auto &r : requests)
+                failures += lib.borrowBook(lib.findUser(r.userId), r.bookId, borrowTime) != OP_OK;
+        }
+        double borrowSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        start = chrono::steady_clock::now();
+        if (bulk) {
+            for (const auto &r : lib.returnMany(requests, returnTime))
+                failures += r.status != OP_OK;
+        } else {
+            for (const auto &r : requests)
+                failures += lib.returnBook(lib.findUser(r.userId), r.bookId, returnTime).status != OP_OK;
+        }
+        double returnSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cout << (bulk ? "Bulk API:    " : "Single-item: ")
+             << static_cast<long long>(loans / borrowSeconds) << " borrows/sec, "
+             << static_cast<long long>(loans / returnSeconds) << " returns/sec"
+             << (failures ? " (" + to_string(failures) + " failed)" : "") << endl;
+    }
+    remove(scratchLog.c_str());
+}
+
+void benchmarkAccountPaging(int userCount, size_t budget, int lookups) {
+    cout << "Registering " << userCount << " users with a budget of " << budget << " resident accounts..." << endl;
+    {
+        TransactionLogScope quiet(false);
+        Library lib;
+        for (int i = 1; i <= userCount; i++)
+            lib.addUser(new Student(i, "Student " + to_string(i), "student" + to_string(i), "pwd", true));
+        lib.setMemoryBudget(budget, "bench_accounts.page");
+        auto start = chrono::steady_clock::now();
+        lib.trimToBudget();
+        double trimSeconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "Initial page-out: " << trimSeconds * 1000 << " ms" << endl;
+
+        // Nine lookups in ten go to a set of regular patrons half the size of
+        // the budget; the rest are spread over everyone.
+        mt19937 rng(7);
+        int hotUsers = max<int>(1, min<size_t>(userCount, budget / 2));
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < lookups; i++) {
+            int userId = rng() % 10 != 0 ? 1 + rng() % hotUsers : 1 + rng() % userCount;
+            lib.findUser(userId);
+            lib.trimToBudget();
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        PagingStats stats = lib.getPagingStats();
+        long long total = stats.hits + stats.faults;
+        cout << lookups << " lookups: " << static_cast<long long>(lookups / seconds) << " lookups/sec, hit rate "
+             << (total ? 100.0 * stats.hits / total : 0) << "%, " << stats.evictions << " evictions" << endl;
+        cout << "Resident: " << stats.residentUsers << " accounts (~" << stats.residentBytes / 1024
+             << " KiB); paged out: " << stats.pagedUsers << " accounts (~" << stats.pageIndexBytes / 1024
+             << " KiB of index)" << endl;
+    }
+}
+
+void benchmarkHoldQueues(int bookCount, int holdsPerBook, int rounds) {
+    cout << "Queueing " << holdsPerBook << " patrons on each of " << bookCount << " borrowed books..." << endl;
+    {
+        TransactionLogScope quiet(false);
+        Library lib;
+        // Each book has its own group of patrons: one borrower and the rest
+        // queued behind them in ID order.
+        int group = holdsPerBook + 1;
+        long long now = 28000000;
+        addBenchLibrary(lib, {bookCount, 1, true, bookCount * group, true});
+        vector<User *> holder(bookCount + 1);
+        for (int b = 1; b <= bookCount; b++) {
+            holder[b] = lib.findUser((b - 1) * group + 1);
+            lib.borrowBook(holder[b], b, now);
+            for (int k = 2; k <= group; k++)
+                lib.reserveBook(lib.findUser((b - 1) * group + k), b, now);
+        }
+
+        // Each round every book is returned, collected by the front of its
+        // queue, and the previous borrower joins the back again, so queue
+        // lengths stay constant.
+        double returnSeconds = 0, collectSeconds = 0;
+        int failures = 0;
+        for (int r = 0; r < rounds; r++) {
+            now += 60;
+            auto start = chrono::steady_clock::now();
+            for (int b = 1; b <= bookCount; b++) {
+                if (lib.returnBook(holder[b], b, now).status != OP_OK)
+                    failures++;
+            }
+            returnSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            vector<User *> previous = holder;
+            start = chrono::steady_clock::now();
+            for (int b = 1; b <= bookCount; b++) {
+                holder[b] = lib.findUser(lib.findBook(b)->getReservedBy());
+                if (lib.borrowReservedBook(holder[b], b, now) != OP_OK)
+                    failures++;
+            }
+            collectSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            for (int b = 1; b <= bookCount; b++)
+                lib.reserveBook(previous[b], b, now);
+        }
+        long long operations = static_cast<long long>(bookCount) * rounds;
+        cout << operations << " returns: " << static_cast<long long>(operations / returnSeconds)
+             << " returns/sec" << endl;
+        cout << operations << " collections with promotion: "
+             << static_cast<long long>(operations / collectSeconds) << " collections/sec" << endl;
+        cout << "Failed operations: " << failures << " | consistency problems: "
+             << lib.checkConsistency().size() << endl;
+    }
+}
+
+void benchmarkAutocomplete(int bookCount, int queries) {
+    mt19937 rng(11);
+    vector<string> vocabulary = syntheticVocabulary(5000, rng);
+    {
+        TransactionLogScope quiet(false);
+        Library lib;
+        addSyntheticCatalog(lib, bookCount, vocabulary, 5, rng);
+        // Completions are ranked by popularity.
+        for (auto b : lib.getBooks())
+            b->setBorrowCount(rng() % 1000);
+
+        // Prefixes of two to four letters, as typed at a kiosk.
+        vector<string> prefixes;
+        for (int i = 0; i < queries; i++) {
+            const string &word = vocabulary[rng() % vocabulary.size()];
+            prefixes.push_back(word.substr(0, 2 + rng() % 3));
+        }
+        size_t found = 0;
+        auto start = chrono::steady_clock::now();
+        for (const string &prefix : prefixes)
+            found += lib.autocomplete(prefix, 10).size();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << queries << " completions (top 10): " << seconds * 1e6 / queries << " us/query, "
+             << found << " suggestions" << endl;
+
+        int scans = max(1, queries / 1000);
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < scans; i++)
+            found += lib.searchBooks(prefixes[i]).size();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << scans << " full-catalog searches: " << seconds * 1e6 / scans << " us/query" << endl;
+    }
+}
+
+void benchmarkFuzzySearch(int bookCount, int queries) {
+    mt19937 rng(13);
+    vector<string> vocabulary = syntheticVocabulary(50000, rng);
+    {
+        TransactionLogScope quiet(false);
+        Library lib;
+        addSyntheticCatalog(lib, bookCount, vocabulary, 4, rng);
+
+        // Author names as typed with one or two mistakes (a letter dropped,
+        // doubled or swapped for another).
+        vector<string> terms;
+        for (int i = 0; i < queries; i++) {
+            string term = vocabulary[rng() % vocabulary.size()];
+            for (int e = 1 + rng() % 2; e > 0; e--) {
+                size_t at = rng() % term.size();
+                switch (rng() % 3) {
+                case 0: term.erase(at, 1); break;
+                case 1: term.insert(at, 1, term[at]); break;
+                default: term[at] = static_cast<char>('a' + rng() % 26); break;
+                }
+            }
+            terms.push_back(term);
+        }
+        size_t found = 0;
+        auto start = chrono::steady_clock::now();
+        for (const string &term : terms)
+            found += lib.advancedSearchBooks(term, 0, 0, 0, true).size();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << queries << " fuzzy searches: " << seconds * 1e3 / queries << " ms/query, "
+             << found << " books found" << endl;
+
+        int scans = max(1, queries / 100);
+        found = 0;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < scans; i++)
+            found += lib.advancedSearchBooks(terms[i], 0, 0, 0, false).size();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << scans << " exact substring searches: " << seconds * 1e3 / scans << " ms/query, "
+             << found << " books found" << endl;
+    }
+}
+
+void benchmarkIsbnLookup(int bookCount, int lookups) {
+    // A few copies of each title, as in a branch library.
+    const int copiesPerTitle = 3;
+    cout << "Building a catalog of " << bookCount << " books..." << endl;
+    {
+        TransactionLogScope quiet(false);
+        Library lib;
+        addBenchLibrary(lib, {bookCount, copiesPerTitle, true, 0, false});
+
+        mt19937 rng(17);
+        int titles = (bookCount + copiesPerTitle - 1) / copiesPerTitle;
+        vector<string> scanned;
+        for (int i = 0; i < lookups; i++)
+            scanned.push_back(formatIsbn(completeIsbn(979000000000ULL + 1 + rng() % titles)));
+        size_t found = 0;
+        auto start = chrono::steady_clock::now();
+        for (const string &isbn : scanned)
+            found += lib.findBooksByIsbn(isbn).size();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << lookups << " ISBN lookups: " << seconds * 1e9 / lookups << " ns/lookup, "
+             << found << " copies found" << endl;
+
+        int scans = max(1, lookups / 10000);
+        found = 0;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < scans; i++) {
+            for (auto b : lib.getBooks()) {
+                if (b->getISBN() == scanned[i])
+                    found++;
+            }
+        }
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << scans << " catalog scans: " << seconds * 1e9 / scans << " ns/lookup, "
+             << found << " copies found" << endl;
+    }
+}
+
+// A synthetic vendor feed in which about one row in twenty repeats an
+// earlier title and one in a hundred has a mistyped ISBN, added title by
+// title through addBook (with an ISBN lookup first, and a log record each)
+// and then imported in one batch.
+void benchmarkCatalogImport(int rows) {
+    const string feedPath = "bench_feed.csv";
+    const string scratchLog = "bench_transactions.log";
+    cout << "Writing a feed of " << rows << " rows..." << endl;
+    {
+        mt19937 rng(19);
+        ofstream feed(feedPath, ios::trunc);
+        feed << "title,author,publisher,year,isbn\n";
+        string isbn;
+        for (int i = 0; i < rows; i++) {
+            int title = (i > 0 && rng() % 20 == 0) ? static_cast<int>(rng() % i) : i;
+            isbn = formatIsbn(completeIsbn(979100000000ULL + title));
+            if (rng() % 100 == 0)
+                isbn[12] = static_cast<char>('0' + (isbn[12] - '0' + 1) % 10);
+            feed << "Feed Title " << title << ",Author " << title % 5000 << ",Feed Press,"
+                 << 1950 + title % 70 << "," << isbn << "\n";
+        }
+    }
+    TransactionLogScope log(true, scratchLog);
+
+    {
+        vector<FeedRow> feedRows;
+        size_t malformed;
+        parseCatalogFeed(feedPath, feedRows, malformed, 1);
+        Library lib;
+        remove(scratchLog.c_str());
+        size_t added = 0;
+        auto start = chrono::steady_clock::now();
+        for (const FeedRow &row : feedRows) {
+            if (lib.findBooksByIsbn(row.isbn).empty() &&
+                lib.addBook(row.title, row.author, row.publisher, row.year, row.isbn) != 0)
+                added++;
+        }
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "addBook one at a time: " << static_cast<long long>(feedRows.size() / seconds)
+             << " rows/sec, " << added << " added" << endl;
+    }
+
+    int maxThreads = max(1u, thread::hardware_concurrency());
+    for (int threads : {1, maxThreads}) {
+        Library lib;
+        remove(scratchLog.c_str());
+        ImportResult result = lib.importCatalog(feedPath, threads);
+        cout << "importCatalog, " << threads << " parser thread(s): "
+             << static_cast<long long>(result.rows / result.seconds) << " rows/sec (parse "
+             << result.parseSeconds * 1000 << " ms, total " << result.seconds * 1000 << " ms), "
+             << result.added << " added, " << result.duplicates << " duplicates, "
+             << result.invalidIsbn << " invalid ISBNs" << endl;
+        if (maxThreads == 1) break;
+    }
+    remove(scratchLog.c_str());
+    remove(feedPath.c_str());
+}
+
+// Kiosk traffic: most searches repeat a few popular terms (some filtered to
+// available books, which depend on circulation), with a loan or return at
+// the desk every twenty searches. Timed with the search cache off and on.
+void benchmarkSearchCache(int bookCount, int queries) {
+    static const char *const subjects[] = {"machine learning", "deep learning", "statistics", "algorithms",
+                                           "databases", "compilers", "networks", "security", "graphics",
+                                           "robotics", "optimization", "probability"};
+    const int subjectCount = sizeof(subjects) / sizeof(subjects[0]);
+    cout << "Building a catalog of " << bookCount << " books..." << endl;
+    {
+        TransactionLogScope quiet(false);
+        Library lib;
+        mt19937 rng(23);
+        for (int b = 1; b <= bookCount; b++) {
+            string title = string("Introduction to ") + subjects[rng() % subjectCount];
+            lib.addBook(title, "Author " + to_string(b % 5000), "Press", 1990 + b % 30,
+                        formatIsbn(completeIsbn(979000000000ULL + b)));
+        }
+        addBenchLibrary(lib, {0, 1, false, 1, true});
+        User *patron = lib.findUser(1);
+
+        // Popular terms are drawn far more often than the rest.
+        vector<int> picks;
+        for (int i = 0; i < queries; i++) {
+            int r = rng() % subjectCount;
+            picks.push_back(r * (rng() % subjectCount) / subjectCount);
+        }
+        // Every search scans the catalog with the cache off, so that pass
+        // replays only the first twentieth of the traffic.
+        for (size_t capacity : {size_t(0), size_t(256)}) {
+            lib.setSearchCacheCapacity(capacity);
+            SearchCacheStats before = lib.getSearchCacheStats();
+            int count = capacity ? queries : max(20, queries / 20);
+            size_t found = 0;
+            int bookId = 1;
+            auto start = chrono::steady_clock::now();
+            for (int i = 0; i < count; i++) {
+                const char *term = subjects[picks[i]];
+                if (i % 10 == 0)
+                    found += lib.advancedSearchBooks(term, 0, 1, 0, false).size();
+                else
+                    found += lib.searchBooks(term).size();
+                if (i % 20 == 19) {
+                    if (lib.findLoan(bookId))
+                        lib.returnBook(patron, bookId, lib.now());
+                    else
+                        lib.borrowBook(patron, bookId, lib.now());
+                    bookId = bookId % 5 + 1;
+                }
+            }
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            SearchCacheStats stats = lib.getSearchCacheStats();
+            cout << count << " searches, cache " << (capacity ? "on" : "off") << ": "
+                 << seconds * 1e6 / count << " us/query, " << found << " books found";
+            if (capacity)
+                cout << " (" << stats.hits - before.hits << " hits, " << stats.misses - before.misses
+                     << " misses, " << stats.stale - before.stale << " stale)";
+            cout << endl;
+        }
+    }
+}
+
+// Students borrow and return a few books each, leaving one loan open and
+// some fines owed, then the circulation report is printed from the
+// maintained figures and recounted from scratch.
+void benchmarkCirculationReports(int userCount, int reports) {
+    cout << "Building a library of " << userCount << " users..." << endl;
+    {
+        TransactionLogScope quiet(false);
+        VirtualClock clock(29000000);
+        Library lib;
+        lib.setClock(&clock);
+        addBenchLibrary(lib, {userCount * 2, 1, false, userCount, false});
+        mt19937 rng(29);
+        for (int i = 1; i <= userCount; i++) {
+            User *user = lib.findUser(i);
+            int first = 2 * i - 1, second = 2 * i;
+            lib.borrowBook(user, first, lib.now());
+            lib.borrowBook(user, second, lib.now());
+            // One student in ten brings a book back late.
+            lib.returnBook(user, first, lib.now() + (rng() % 10 == 0 ? 20 : 1) * 24 * 60);
+        }
+
+        size_t shown = 0;
+        auto start = chrono::steady_clock::now();
+        for (int i = 0; i < reports; i++)
+            shown += lib.getCirculationReport(10).mostBorrowed.size();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << reports << " circulation reports: " << seconds * 1e6 / reports << " us/report, "
+             << shown << " ranked books shown" << endl;
+
+        start = chrono::steady_clock::now();
+        size_t problems = lib.checkReports().size();
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        cout << "Full recount: " << seconds * 1e3 << " ms, " << problems << " mismatches" << endl;
+    }
+}
@@ -0,0 +1,61 @@
+/*
+ * Simulation.h
+ *
+ * This file declares the circulation simulator. It builds a library with a
+ * synthetic population of students and faculty, drives it with a VirtualClock
+ * and replays randomized borrowing behaviour (borrow, return, renew, reserve,
+ * collect, cancel, pay fine) over simulated days as fast as the CPU allows.
+ *
+ * Transaction logging is suppressed while the simulation runs. At the end it
+ * reports operations per second and a checksum of the final library state,
+ * which is identical for identical parameters and seed.
+ *
+ * benchmarkBulkCirculation() borrows and returns the same set of loans through
+ * the single-item calls and through the bulk API, with transaction logging
+ * enabled (to a scratch file), and compares their throughput.
+ *
+ * benchmarkAccountPaging() registers a large population of idle users under a
+ * memory budget and looks them up with a skewed access pattern (most lookups
+ * go to a small set of regular patrons), reporting lookup throughput, the
+ * paging hit rate and the resident size.
+ *
+ * benchmarkHoldQueues() keeps every book on loan with a long queue of
+ * patrons waiting for it and times the returns and the collections (each of
+ * which promotes the next patron in the queue).
+ *
+ * benchmarkAutocomplete() builds a synthetic catalog and times prefix
+ * completions against the full-catalog substring search.
+ *
+ * benchmarkFuzzySearch() times typo-tolerant advanced searches for words
+ * with one or two mistakes against exact substring searches.
+ *
+ * benchmarkIsbnLookup() times ISBN lookups through the index against scans
+ * of the catalog.
+ *
+ * benchmarkCatalogImport() writes a synthetic vendor feed and compares adding
+ * it title by title with importing it in one batch.
+ *
+ * benchmarkSearchCache() replays kiosk searches for a few popular terms,
+ * interleaved with loans and returns, with the search cache off and on.
+ *
+ * benchmarkCirculationReports() times the circulation report, read from the
+ * figures kept up to date by each operation, against a full recount.
+ */
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <cstddef>
+
+void runSimulation(int userCount, int bookCount, int days, unsigned seed);
+void benchmarkBulkCirculation(int loans);
+void benchmarkAccountPaging(int userCount, size_t budget, int lookups);
+void benchmarkHoldQueues(int bookCount, int holdsPerBook, int rounds);
+void benchmarkAutocomplete(int bookCount, int queries);
+void benchmarkFuzzySearch(int bookCount, int queries);
+void benchmarkIsbnLookup(int bookCount, int lookups);
+void benchmarkCatalogImport(int rows);
+void benchmarkSearchCache(int bookCount, int queries);
+void benchmarkCirculationReports(int userCount, int reports);
+
+#endif
@@ -0,0 +1,187 @@
+/*
+ * SlotMap.h
+ *
+ * This file declares the SlotMap class template, the container the Library
+ * keeps its books and users in. Records are addressed by their own ID, which
+ * never changes, and are kept in ascending ID order for paged listings.
+ *
+ * Records live in a vector of slots in ID order, with a hash index from ID to
+ * slot, so finding a record is O(1). Removing one only clears its slot,
+ * leaving a tombstone, which is also O(1): nothing after it moves and its ID
+ * stays indexed. Iteration skips tombstones. A record whose ID still has a
+ * tombstone (for example a user read back after being paged out) is put back
+ * into that slot in O(1), and records with an ID above every other one are
+ * appended. An ID that falls between existing slots takes over the nearest
+ * tombstone, moving only the slots in between.
+ *
+ * Once tombstones outnumber live records (and there are more than a few of
+ * them) the slots are compacted in one pass, so the cost is amortised over
+ * the removals that made them. The SlotMap holds pointers and never deletes
+ * them; ownership stays with the caller.
+ */
+
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+template <typename T>
+class SlotMap {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = T *;
+        using difference_type = ptrdiff_t;
+        using pointer = T *const *;
+        using reference = T *const &;
+
+        const_iterator(const vector<T *> *slots, size_t pos) : slots(slots), pos(pos) { skip(); }
+        reference operator*() const { return (*slots)[pos]; }
+        const_iterator &operator++() {
+            ++pos;
+            skip();
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+        bool operator==(const const_iterator &other) const { return pos == other.pos; }
+        bool operator!=(const const_iterator &other) const { return pos != other.pos; }
+
+    private:
+        void skip() {
+            while (pos < slots->size() && !(*slots)[pos])
+                ++pos;
+        }
+
+        const vector<T *> *slots;
+        size_t pos;
+    };
+
+    SlotMap() : live(0) {}
+
+    const_iterator begin() const { return const_iterator(&slots, 0); }
+    const_iterator end() const { return const_iterator(&slots, slots.size()); }
+
+    // The first live record with an ID greater than id.
+    const_iterator upperBound(int id) const {
+        return const_iterator(&slots, upper_bound(ids.begin(), ids.end(), id) - ids.begin());
+    }
+
+    size_t size() const { return live; }
+    bool empty() const { return live == 0; }
+    size_t tombstones() const { return slots.size() - live; }
+
+    T *find(int id) const {
+        auto it = index.find(id);
+        return it == index.end() ? nullptr : slots[it->second];
+    }
+
+    // Returns false, leaving the map unchanged, if a live record already has
+    // this ID.
+    bool insert(int id, T *item) {
+        auto it = index.find(id);
+        if (it != index.end()) {
+            if (slots[it->second])
+                return false;
+            slots[it->second] = item;
+        } else if (ids.empty() || id > ids.back()) {
+            index[id] = slots.size();
+            ids.push_back(id);
+            slots.push_back(item);
+        } else {
+            insertBetween(lower_bound(ids.begin(), ids.end(), id) - ids.begin(), id, item);
+        }
+        live++;
+        return true;
+    }
+
+    // Leaves a tombstone and returns the record, or nullptr if there is none.
+    T *erase(int id) {
+        auto it = index.find(id);
+        if (it == index.end() || !slots[it->second])
+            return nullptr;
+        T *item = slots[it->second];
+        slots[it->second] = nullptr;
+        live--;
+        if (tombstones() > live && tombstones() > COMPACT_MIN)
+            compact();
+        return item;
+    }
+
+    // Drops every tombstone and reindexes the remaining slots.
+    void compact() {
+        size_t out = 0;
+        index.clear();
+        for (size_t i = 0; i < slots.size(); i++) {
+            if (!slots[i])
+                continue;
+            slots[out] = slots[i];
+            ids[out] = ids[i];
+            index[ids[out]] = out;
+            out++;
+        }
+        slots.resize(out);
+        ids.resize(out);
+    }
+
+    void clear() {
+        slots.clear();
+        ids.clear();
+        index.clear();
+        live = 0;
+    }
+
+private:
+    static const size_t COMPACT_MIN = 64;
+
+    // Makes room at pos by moving the slots between pos and the nearest
+    // tombstone one place towards it (the tombstone's ID is dropped), or by
+    // moving every later slot up if there is no tombstone.
+    void insertBetween(size_t pos, int id, T *item) {
+        size_t left = pos, right = pos;
+        while (left > 0 || right < slots.size()) {
+            if (right < slots.size() && !slots[right]) {
+                index.erase(ids[right]);
+                for (size_t i = right; i > pos; i--)
+                    place(i, ids[i - 1], slots[i - 1]);
+                place(pos, id, item);
+                return;
+            }
+            if (left > 0 && !slots[left - 1]) {
+                index.erase(ids[left - 1]);
+                for (size_t i = left - 1; i + 1 < pos; i++)
+                    place(i, ids[i + 1], slots[i + 1]);
+                place(pos - 1, id, item);
+                return;
+            }
+            if (left > 0) left--;
+            if (right < slots.size()) right++;
+        }
+        ids.insert(ids.begin() + pos, id);
+        slots.insert(slots.begin() + pos, item);
+        for (size_t i = pos; i < ids.size(); i++)
+            index[ids[i]] = i;
+    }
+
+    void place(size_t slot, int id, T *item) {
+        ids[slot] = id;
+        slots[slot] = item;
+        index[id] = slot;
+    }
+
+    vector<T *> slots;
+    vector<int> ids;
+    unordered_map<int, size_t> index;
+    size_t live;
+};
+
+#endif
@@ -0,0 +1,31 @@
+/*
+ * Status.cpp
+ *
+ * This file implements opStatusToString() declared in Status.h.
+ */
+
+#include "Status.h"
+using namespace std;
+
+string opStatusToString(OpStatus status) {
+    switch (status) {
+        case OP_OK: return "Success.";
+        case OP_INVALID_USER: return "Invalid user.";
+        case OP_USER_NOT_FOUND: return "User not found.";
+        case OP_BOOK_NOT_FOUND: return "Book not found.";
+        case OP_BOOK_NOT_AVAILABLE: return "Book is not available for borrowing.";
+        case OP_BOOK_IS_AVAILABLE: return "Book is available. You can borrow it instead of reserving.";
+        case OP_ALREADY_RESERVED: return "You already have a hold on this book.";
+        case OP_RESERVED_BY_OTHER: return "Book is reserved by another user. Renewal denied.";
+        case OP_NOT_RESERVED_BY_USER: return "No reserved book found for you with this ID.";
+        case OP_RESERVATION_EXPIRED: return "Reservation expired. The book is now available.";
+        case OP_NOT_BORROWED: return "You have not borrowed this book.";
+        case OP_FINE_OUTSTANDING: return "Outstanding fine. Please clear your fine before borrowing.";
+        case OP_LIMIT_REACHED: return "Reached maximum borrowing limit.";
+        case OP_LONG_OVERDUE: return "Cannot borrow more books as one of your books is overdue by more than 60 days.";
+        case OP_NOT_ALLOWED: return "Librarians are not allowed to borrow books.";
+        case OP_INVALID_USER_TYPE: return "Invalid user type.";
+        case OP_INVALID_ISBN: return "Invalid ISBN. Enter 10 or 13 digits with a correct check digit.";
+    }
+    return "Unknown status.";
+}
@@ -0,0 +1,37 @@
+/*
+ * Status.h
+ *
+ * This file declares OpStatus, the result code returned by every library
+ * operation that can be refused (borrow, return, renew, reserve, cancel, ...),
+ * and opStatusToString(), which gives the message shown to the user.
+ */
+
+#ifndef STATUS_H
+#define STATUS_H
+
+#include <string>
+using namespace std;
+
+enum OpStatus {
+    OP_OK,
+    OP_INVALID_USER,
+    OP_USER_NOT_FOUND,
+    OP_BOOK_NOT_FOUND,
+    OP_BOOK_NOT_AVAILABLE,
+    OP_BOOK_IS_AVAILABLE,
+    OP_ALREADY_RESERVED,
+    OP_RESERVED_BY_OTHER,
+    OP_NOT_RESERVED_BY_USER,
+    OP_RESERVATION_EXPIRED,
+    OP_NOT_BORROWED,
+    OP_FINE_OUTSTANDING,
+    OP_LIMIT_REACHED,
+    OP_LONG_OVERDUE,
+    OP_NOT_ALLOWED,
+    OP_INVALID_USER_TYPE,
+    OP_INVALID_ISBN
+};
+
+string opStatusToString(OpStatus status);
+
+#endif
@@ -0,0 +1,158 @@
+/*
+ * TextFold.cpp
+ *
+ * This file implements foldText(), declared in TextFold.h.
+ */
+
+#include "TextFold.h"
+#include <cstdint>
+#include <cstring>
+using namespace std;
+
+namespace {
+
+// Base letters for U+00C0 to U+00FF, lower case; '*' marks characters that
+// are kept (× and ÷) and '+' ones spelled out by foldCodePoint.
+const char LATIN1[] =
+    "aaaaaa+ceeeeiiii"
+    "dnooooo*ouuuuy+s"
+    "aaaaaa+ceeeeiiii"
+    "dnooooo*ouuuuy+y";
+
+// Base letters for U+0100 to U+017F (Latin Extended-A).
+const char LATIN_EXTENDED_A[] =
+    "aaaaaaccccccccdd"
+    "ddeeeeeeeeeegggg"
+    "gggghhhhiiiiiiii"
+    "ii++jjkkklllllll"
+    "lllnnnnnnnnnoooo"
+    "oo++rrrrrrssssss"
+    "ssttttttuuuuuuuu"
+    "uuuuwwyyyzzzzzzs";
+
+struct LowerTable {
+    char map[128];
+    LowerTable() {
+        for (int c = 0; c < 128; c++)
+            map[c] = static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+    }
+};
+
+const LowerTable lower;
+
+bool isAscii(string_view text) {
+    size_t i = 0;
+    for (; i + 8 <= text.size(); i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, text.data() + i, sizeof(chunk));
+        if (chunk & 0x8080808080808080ULL)
+            return false;
+    }
+    for (; i < text.size(); i++) {
+        if (static_cast<unsigned char>(text[i]) >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+void appendUtf8(string &out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+void foldCodePoint(string &out, uint32_t cp) {
+    if (cp >= 0x300 && cp <= 0x36F)
+        return;
+    switch (cp) {
+    case 0xC6: case 0xE6: out += "ae"; return;
+    case 0xDE: case 0xFE: out += "th"; return;
+    case 0xDF: out += "ss"; return;
+    case 0x132: case 0x133: out += "ij"; return;
+    case 0x152: case 0x153: out += "oe"; return;
+    }
+    if (cp >= 0xC0 && cp <= 0xFF && LATIN1[cp - 0xC0] != '*') {
+        out += LATIN1[cp - 0xC0];
+        return;
+    }
+    if (cp >= 0x100 && cp <= 0x17F) {
+        out += LATIN_EXTENDED_A[cp - 0x100];
+        return;
+    }
+    if ((cp >= 0x391 && cp <= 0x3A9 && cp != 0x3A2) || (cp >= 0x410 && cp <= 0x42F))
+        cp += 0x20;
+    else if (cp >= 0x400 && cp <= 0x40F)
+        cp += 0x50;
+    appendUtf8(out, cp);
+}
+
+// Decodes one UTF-8 sequence starting at text[i]; returns its length, or 0
+// if the bytes there are not a well-formed sequence.
+size_t decodeUtf8(string_view text, size_t i, uint32_t &cp) {
+    unsigned char c = static_cast<unsigned char>(text[i]);
+    size_t length;
+    if (c >= 0xF0 && c <= 0xF4) {
+        length = 4;
+        cp = c & 0x07;
+    } else if (c >= 0xE0 && c < 0xF0) {
+        length = 3;
+        cp = c & 0x0F;
+    } else if (c >= 0xC2 && c < 0xE0) {
+        length = 2;
+        cp = c & 0x1F;
+    } else {
+        return 0;
+    }
+    if (i + length > text.size())
+        return 0;
+    for (size_t k = 1; k < length; k++) {
+        unsigned char next = static_cast<unsigned char>(text[i + k]);
+        if ((next & 0xC0) != 0x80)
+            return 0;
+        cp = (cp << 6) | (next & 0x3F);
+    }
+    return length;
+}
+
+}
+
+string foldText(string_view text) {
+    string out;
+    if (isAscii(text)) {
+        out.resize(text.size());
+        for (size_t i = 0; i < text.size(); i++)
+            out[i] = lower.map[static_cast<unsigned char>(text[i])];
+        return out;
+    }
+    out.reserve(text.size());
+    for (size_t i = 0; i < text.size();) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c < 0x80) {
+            out += lower.map[c];
+            i++;
+            continue;
+        }
+        uint32_t cp;
+        size_t length = decodeUtf8(text, i, cp);
+        if (length == 0) {
+            out += text[i];
+            i++;
+            continue;
+        }
+        foldCodePoint(out, cp);
+        i += length;
+    }
+    return out;
+}
@@ -0,0 +1,30 @@
+/*
+ * TextFold.h
+ *
+ * This file declares foldText(), which turns UTF-8 text into the form that
+ * searches compare: lower case with accents removed, so "GÉRON", "Géron" and
+ * "geron" all fold to "geron".
+ *
+ * Text that is plain ASCII (most titles) is lowercased through a table, eight
+ * bytes checked at a time. Otherwise the text is decoded and:
+ * - Latin-1 and Latin Extended-A letters fold to their base letter (é -> e,
+ *   ł -> l), and ligatures and ß spell out (æ -> ae, œ -> oe, ß -> ss);
+ * - Greek and Cyrillic capitals fold to lower case;
+ * - combining accents (U+0300 to U+036F) are dropped, so text typed with a
+ *   separate accent character folds the same as with a precomposed one;
+ * - anything else, including malformed UTF-8, is kept unchanged.
+ *
+ * This covers the scripts in the catalog; it is not full Unicode case
+ * folding or normalization.
+ */
+
+#ifndef TEXTFOLD_H
+#define TEXTFOLD_H
+
+#include <string>
+#include <string_view>
+using namespace std;
+
+string foldText(string_view text);
+
+#endif
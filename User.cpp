@@ -5,7 +5,8 @@
  * (Student, Faculty, and Librarian).
  *
  * It defines methods for user authentication, profile updates, borrowing and
- * returning books, and printing user details.
+ * returning books, and printing user details. Borrowing checks return an
+ * OpStatus; nothing here reads from or writes to the console except printDetails().
  * The derived classes override the virtual methods to provide role-specific behavior.
  */
 
@@ -30,6 +31,16 @@ int User::getUserId() const { return userId; }
 string User::getName() const { return name; }
 string User::getUsername() const { return username; }
 string User::getHashedPassword() const { return password; }
+
+// Approximate bytes held by the user and their account; strings short enough
+// for the small-string buffer add nothing beyond the object itself.
+size_t User::memoryFootprint() const {
+    size_t bytes = sizeof(User) - sizeof(Account) + account.memoryFootprint();
+    for (const string *s : {&name, &username, &password})
+        if (s->capacity() >= sizeof(string))
+            bytes += s->capacity() + 1;
+    return bytes;
+}
 Account &User::getAccount() { return account; }
 
 void User::setPasswordRaw(const string &rawPwd) {
@@ -40,68 +51,61 @@ bool User::authenticate(const string &uname, const string &enteredPwd) const {
     return (username == uname && password == hashPassword(enteredPwd));
 }
 
-void User::updateProfile() {
-    cin.ignore();
-    cout << "Enter new name (or press enter to keep current name (" << name << ")): " << endl;
-    string newName;
-    getline(cin, newName);
+// Empty arguments keep the current value.
+void User::updateProfile(const string &newName, const string &newPwd) {
     if (!newName.empty())
         name = newName;
-    cout << "Enter new password (or press enter to keep current password): " << endl;
-    string newPwd;
-    getline(cin, newPwd);
     if (!newPwd.empty())
         setPasswordRaw(newPwd);
-    cout << "Profile updated successfully." << endl;
     logTransaction(userId, "Updated profile");
 }
 
-bool User::canBorrow(long long currentTime, const vector<Book*> &libraryBooks) {
-    if (account.getFine() > 0) {
-        cout << "Outstanding fine: " << account.getFine() << ". Please clear your fine before borrowing." << endl;
-        return false;
-    }
-    if (account.getBorrowedCount() >= getMaxBooks()) {
-        cout << "Reached maximum borrowing limit." << endl;
-        return false;
-    }
-    return true;
+OpStatus User::canBorrow(long long currentTime) {
+    if (account.getFineCents() > 0)
+        return OP_FINE_OUTSTANDING;
+    if (account.getBorrowedCount() >= getMaxBooks())
+        return OP_LIMIT_REACHED;
+    return additionalBorrowCheck(currentTime);
 }
 
-bool User::additionalBorrowCheck(long long currentTime, const vector<Book*> &libraryBooks) {
-    return true;
+OpStatus User::additionalBorrowCheck(long long currentTime) {
+    return OP_OK;
 }
 
-bool User::borrowBook(Book *book, long long currentTime, const vector<Book*> &libraryBooks) {
-    if (!canBorrow(currentTime, libraryBooks))
-        return false;
+OpStatus User::borrowBook(Book *book, long long currentTime) {
+    OpStatus status = canBorrow(currentTime);
+    if (status != OP_OK)
+        return status;
     account.addBorrowedBook(book->getBookId(), currentTime);
     book->setStatus(BORROWED);
-    if (book->getReservedBy() == userId)
+    if (book->getReservedBy() == userId) {
         book->setReservedBy(0);
+        book->setReserveTime(0);
+    }
     book->incrementBorrowCount();
-    cout << name << " borrowed book: " << book->getTitle() << endl;
-    return true;
+    return OP_OK;
 }
 
-void User::returnBook(Book *book, long long returnTime) {
-    bool success = account.returnBook(book->getBookId(), returnTime, getBorrowPeriod(), getFinePerDay());
+bool User::returnBook(Book *book, long long returnTime, BorrowHistory &record) {
+    bool success = account.returnBook(book->getBookId(), returnTime, getBorrowPeriod(), getFinePerDay(), record);
     if (success) {
         book->setStatus(AVAILABLE);
         if (book->getReservedBy() != 0)
             book->setStatus(RESERVED);
-        cout << name << " returned book: " << book->getTitle() << endl;
     }
+    return success;
 }
 
-void User::printDetails() const {
-    cout << "User ID: " << userId << endl
-         << "Name: " << name << endl
-         << "Role: " << getRole() << endl;
+void User::printDetails(ostream &out) const {
+    out << "User ID: " << userId << "\n"
+        << "Name: " << name << "\n"
+        << "Role: " << getRole() << "\n";
 }
 
 Student::Student(int id, const string &n, const string &uname, const string &pwd, bool isAlreadyHashed)
-    : User(id, n, uname, pwd, isAlreadyHashed) {}
+    : User(id, n, uname, pwd, isAlreadyHashed) {
+    account.setBorrowPeriod(getBorrowPeriod());
+}
 
 int Student::getMaxBooks() const { return 3; }
 int Student::getBorrowPeriod() const { return 15; }
@@ -109,42 +113,31 @@ int Student::getFinePerDay() const { return 10; }
 string Student::getRole() const { return "Student"; }
 
 Faculty::Faculty(int id, const string &n, const string &uname, const string &pwd, bool isAlreadyHashed)
-    : User(id, n, uname, pwd, isAlreadyHashed) {}
+    : User(id, n, uname, pwd, isAlreadyHashed) {
+    account.setBorrowPeriod(getBorrowPeriod());
+}
 
 int Faculty::getMaxBooks() const { return 5; }
 int Faculty::getBorrowPeriod() const { return 30; }
 int Faculty::getFinePerDay() const { return 0; }
 string Faculty::getRole() const { return "Faculty"; }
-bool Faculty::additionalBorrowCheck(long long currentTime, const vector<Book*> &libraryBooks) {
-    const vector<BorrowedBook> &books = account.getBorrowedBooks();
-    for (auto &bb : books) {
-        long long limit = 60LL * 24 * 60;
-        if (currentTime - bb.borrowTime > limit) {
-            cout << "Cannot borrow more books as one of your books is overdue by more than 60 days." << endl;
-            return false;
-        }
-    }
-    return true;
-}
-bool Faculty::borrowBook(Book *book, long long currentTime, const vector<Book*> &libraryBooks) {
-    if (!canBorrow(currentTime, libraryBooks) || !additionalBorrowCheck(currentTime, libraryBooks))
-        return false;
-    account.addBorrowedBook(book->getBookId(), currentTime);
-    book->setStatus(BORROWED);
-    book->incrementBorrowCount();
-    cout << name << " borrowed book: " << book->getTitle() << endl;
-    return true;
+OpStatus Faculty::additionalBorrowCheck(long long currentTime) {
+    long long limit = 60LL * 24 * 60;
+    if (account.getBorrowedCount() > 0 && currentTime - account.getOldestBorrowTime() > limit)
+        return OP_LONG_OVERDUE;
+    return OP_OK;
 }
 
 Librarian::Librarian(int id, const string &n, const string &uname, const string &pwd, bool isAlreadyHashed)
-    : User(id, n, uname, pwd, isAlreadyHashed) {}
+    : User(id, n, uname, pwd, isAlreadyHashed) {
+    account.setBorrowPeriod(getBorrowPeriod());
+}
 
 int Librarian::getMaxBooks() const { return 0; }
 int Librarian::getBorrowPeriod() const { return 0; }
 int Librarian::getFinePerDay() const { return 0; }
 string Librarian::getRole() const { return "Librarian"; }
-bool Librarian::borrowBook(Book *book, long long currentTime, const vector<Book*> &libraryBooks) {
-    cout << "Librarians are not allowed to borrow books." << endl;
-    return false;
+OpStatus Librarian::canBorrow(long long currentTime) {
+    return OP_NOT_ALLOWED;
 }
  
\ No newline at end of file
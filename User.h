@@ -5,8 +5,9 @@
  * Student, Faculty, and Librarian.
  *
  * The User class represents a library user with an associated Account.
- * It declares virtual functions such as borrowBook() and returnBook() that
- * are overridden in derived classes to enforce role-specific borrowing rules.
+ * It declares virtual functions such as canBorrow() and additionalBorrowCheck()
+ * that are overridden in derived classes to enforce role-specific borrowing
+ * rules. Refusals are reported as OpStatus codes rather than printed.
  *
  * The constructor accepts a flag (isAlreadyHashed) to ensure that raw passwords
  * are hashed only once.
@@ -16,6 +17,8 @@
 #define USER_H
 
 #include "Account.h"
+#include "Status.h"
+#include <iostream>
 #include <string>
 #include <vector>
 using namespace std;
@@ -31,21 +34,22 @@ public:
     string getUsername() const;
     string getHashedPassword() const;
     Account &getAccount();
+    size_t memoryFootprint() const;
 
     void setPasswordRaw(const string &rawPwd);
     bool authenticate(const string &uname, const string &enteredPwd) const;
-    void updateProfile();
+    void updateProfile(const string &newName, const string &newPwd);
 
     virtual int getMaxBooks() const = 0;
     virtual int getBorrowPeriod() const = 0;
     virtual int getFinePerDay() const = 0;
     virtual string getRole() const = 0;
 
-    virtual bool canBorrow(long long currentTime, const vector<Book*> &libraryBooks);
-    virtual bool additionalBorrowCheck(long long currentTime, const vector<Book*> &libraryBooks);
-    virtual bool borrowBook(Book *book, long long currentTime, const vector<Book*> &libraryBooks);
-    virtual void returnBook(Book *book, long long returnTime);
-    virtual void printDetails() const;
+    virtual OpStatus canBorrow(long long currentTime);
+    virtual OpStatus additionalBorrowCheck(long long currentTime);
+    virtual OpStatus borrowBook(Book *book, long long currentTime);
+    virtual bool returnBook(Book *book, long long returnTime, BorrowHistory &record);
+    virtual void printDetails(ostream &out = cout) const;
 
 protected:
     int userId;
@@ -71,8 +75,7 @@ public:
     virtual int getBorrowPeriod() const override;
     virtual int getFinePerDay() const override;
     virtual string getRole() const override;
-    virtual bool additionalBorrowCheck(long long currentTime, const vector<Book*> &libraryBooks) override;
-    virtual bool borrowBook(Book *book, long long currentTime, const vector<Book*> &libraryBooks) override;
+    virtual OpStatus additionalBorrowCheck(long long currentTime) override;
 };
 
 class Librarian : public User {
@@ -82,7 +85,7 @@ public:
     virtual int getBorrowPeriod() const override;
     virtual int getFinePerDay() const override;
     virtual string getRole() const override;
-    virtual bool borrowBook(Book *book, long long currentTime, const vector<Book*> &libraryBooks) override;
+    virtual OpStatus canBorrow(long long currentTime) override;
 };
 
 #endif
\ No newline at end of file
@@ -15,6 +15,18 @@
 #include <iostream>
 using namespace std;
 
+static bool transactionLoggingEnabled = true;
+static string transactionLogPath = "transactions.log";
+
+static string currentTimeString() {
+    auto now = chrono::system_clock::now();
+    time_t now_time = chrono::system_clock::to_time_t(now);
+    string timeStr = ctime(&now_time);
+    if (!timeStr.empty() && timeStr[timeStr.size() - 1] == '\n')
+        timeStr.erase(timeStr.size() - 1);
+    return timeStr;
+}
+
 string trim(const string &s) {
     size_t start = s.find_first_not_of(" \t\n\r");
     if (start == string::npos) return "";
@@ -32,15 +44,59 @@ long long getCurrentTimeInMinutes() {
         .count();
 }
 
+string formatDate(long long minutes) {
+    time_t seconds = static_cast<time_t>(minutes * 60);
+    tm date;
+    char text[16];
+#ifndef _WIN32
+    bool converted = gmtime_r(&seconds, &date) != nullptr;
+#else
+    bool converted = gmtime_s(&date, &seconds) == 0;
+#endif
+    if (!converted || strftime(text, sizeof(text), "%Y-%m-%d", &date) == 0)
+        return "?";
+    return text;
+}
+
 void logTransaction(int userId, const string &message) {
-    ofstream logfile("transactions.log", ios::app);
+    if (!transactionLoggingEnabled) return;
+    ofstream logfile(transactionLogPath, ios::app);
+    if (logfile.is_open()) {
+        logfile << "User " << userId << " at " << currentTimeString() << ": " << message << endl;
+        logfile.close();
+    }
+}
+
+// Formats all entries in memory and appends them with one write and one flush.
+void logTransactions(const vector<pair<int, string>> &entries) {
+    if (!transactionLoggingEnabled || entries.empty()) return;
+    string timeStr = currentTimeString();
+    string buffer;
+    for (const auto &entry : entries)
+        buffer += "User " + to_string(entry.first) + " at " + timeStr + ": " + entry.second + "\n";
+    ofstream logfile(transactionLogPath, ios::app);
     if (logfile.is_open()) {
-        auto now = chrono::system_clock::now();
-        time_t now_time = chrono::system_clock::to_time_t(now);
-        string timeStr = ctime(&now_time);
-        if (!timeStr.empty() && timeStr[timeStr.size() - 1] == '\n')
-            timeStr.erase(timeStr.size() - 1);
-        logfile << "User " << userId << " at " << timeStr << ": " << message << endl;
+        logfile.write(buffer.data(), buffer.size());
         logfile.close();
     }
 }
+
+void setTransactionLogPath(const string &path) {
+    transactionLogPath = path;
+}
+
+void setTransactionLogging(bool enabled) {
+    transactionLoggingEnabled = enabled;
+}
+
+TransactionLogScope::TransactionLogScope(bool enabled, const string &path)
+    : previousEnabled(transactionLoggingEnabled), previousPath(transactionLogPath) {
+    transactionLoggingEnabled = enabled;
+    if (!path.empty())
+        transactionLogPath = path;
+}
+
+TransactionLogScope::~TransactionLogScope() {
+    transactionLoggingEnabled = previousEnabled;
+    transactionLogPath = previousPath;
+}
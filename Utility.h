@@ -5,18 +5,43 @@
  * - trim(): Removes leading and trailing whitespace from a string.
  * - hashPassword(): Hashes a password using std::hash.
  * - getCurrentTimeInMinutes(): Returns the current time in minutes since the epoch.
+ * - formatDate(): Formats a time in minutes since the epoch as a UTC date (YYYY-MM-DD).
  * - logTransaction(): Logs transactions to a file.
+ * - logTransactions(): Logs a batch of transactions with a single file write.
+ * - setTransactionLogPath(): Redirects the transaction log to another file.
+ * - setTransactionLogging(): Turns transaction logging on or off (on by default).
+ * - TransactionLogScope: Changes both settings until the end of a scope, then
+ *   puts back the ones it found (used by the benchmarks).
  */
 
 #ifndef UTILITY_H
 #define UTILITY_H
 
 #include <string>
+#include <utility>
+#include <vector>
 using namespace std;
 
 string trim(const string &s);
 string hashPassword(const string &pwd);
 long long getCurrentTimeInMinutes();
+string formatDate(long long minutes);
 void logTransaction(int userId, const string &message);
+void logTransactions(const vector<pair<int, string>> &entries);
+void setTransactionLogPath(const string &path);
+void setTransactionLogging(bool enabled);
+
+class TransactionLogScope {
+public:
+    // An empty path keeps the current log file.
+    explicit TransactionLogScope(bool enabled, const string &path = "");
+    ~TransactionLogScope();
+    TransactionLogScope(const TransactionLogScope &) = delete;
+    TransactionLogScope &operator=(const TransactionLogScope &) = delete;
+
+private:
+    bool previousEnabled;
+    string previousPath;
+};
 
 #endif
@@ -3,45 +3,178 @@
  *
  * This is the entry point of the Library Management System.
  * It displays a login prompt, and after successful login, displays a menu tailored to the user role.
- * The program uses the Library class to manage books, users, and transactions.
+ * The program uses the Library class to manage books, users, and transactions,
+ * and LibraryConsole to prompt for input and print the results.
  * Data is saved on exit.
+ *
+ * Command-line modes (no login prompt):
+ *   --batch <file> [--quiet]   Execute a command file against the library and save.
+ *   --simulate [users books days seed]   Run the circulation simulator.
+ *   --bench-fines [loans]      Benchmark the fine-accrual engine.
+ *   --bench-analytics [records]   Benchmark the history analytics engine.
+ *   --bench-circulation [loans]   Compare single-item and bulk borrow/return.
+ *   --export-jsonl [prefix]    Export the saved data as JSON Lines files.
+ *   --export-columnar [file]   Export the saved data to one columnar binary file.
+ *   --bench-export [users history]   Benchmark both exporters.
+ *   --bench-paging [users budget lookups]   Benchmark account paging.
+ *   --bench-holds [books holds rounds]   Benchmark returns on heavily reserved books.
+ *   --bench-autocomplete [books queries]   Benchmark prefix completion.
+ *   --bench-fuzzy [books queries]   Benchmark typo-tolerant search.
+ *   --bench-isbn [books lookups]   Benchmark ISBN lookups.
+ *   --bench-import [rows]   Benchmark bulk catalog import.
+ *   --bench-search-cache [books queries]   Benchmark repeated searches with and without the cache.
+ *   --bench-reports [users reports]   Benchmark the circulation report against a full recount.
+ *
+ * --memory-budget <users> may be given before the interactive or batch mode
+ * to keep at most that many accounts in memory, paging idle ones to disk.
  */
 
  #include "Library.h"
+ #include "LibraryConsole.h"
  #include "Utility.h"
+ #include "FineAccrual.h"
+ #include "HistoryAnalytics.h"
+ #include "Simulation.h"
+ #include "BatchRunner.h"
+ #include "Clock.h"
+ #include "Export.h"
  #include <iostream>
+ #include <string>
  using namespace std;
 
+ void seedSampleData(LibraryConsole &console);
  void printUserHelp();
  void printLibrarianHelp();
  void showUserMenu();
  void showLibrarianMenu();
  
- int main() {
+ int main(int argc, char *argv[]) {
+     size_t memoryBudget = 0;
+     for (int i = 1; i + 1 < argc; i++) {
+         if (string(argv[i]) == "--memory-budget") {
+             memoryBudget = stoull(argv[i + 1]);
+             for (int j = i; j + 2 <= argc; j++)
+                 argv[j] = argv[j + 2];
+             argc -= 2;
+             break;
+         }
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-fines") {
+         size_t loans = argc > 2 ? stoull(argv[2]) : 10000000;
+         benchmarkFineAccrual(loans);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-analytics") {
+         size_t records = argc > 2 ? stoull(argv[2]) : 10000000;
+         benchmarkHistoryAnalytics(records);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--simulate") {
+         int userCount = argc > 2 ? stoi(argv[2]) : 1000;
+         int bookCount = argc > 3 ? stoi(argv[3]) : 5000;
+         int days = argc > 4 ? stoi(argv[4]) : 365;
+         unsigned seed = argc > 5 ? stoul(argv[5]) : 1;
+         runSimulation(userCount, bookCount, days, seed);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-circulation") {
+         int loans = argc > 2 ? stoi(argv[2]) : 10000;
+         benchmarkBulkCirculation(loans);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-paging") {
+         int userCount = argc > 2 ? stoi(argv[2]) : 1000000;
+         size_t budget = argc > 3 ? stoull(argv[3]) : 10000;
+         int lookups = argc > 4 ? stoi(argv[4]) : 200000;
+         benchmarkAccountPaging(userCount, budget, lookups);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-holds") {
+         int bookCount = argc > 2 ? stoi(argv[2]) : 2000;
+         int holdsPerBook = argc > 3 ? stoi(argv[3]) : 50;
+         int rounds = argc > 4 ? stoi(argv[4]) : 20;
+         benchmarkHoldQueues(bookCount, holdsPerBook, rounds);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-autocomplete") {
+         int bookCount = argc > 2 ? stoi(argv[2]) : 200000;
+         int queries = argc > 3 ? stoi(argv[3]) : 100000;
+         benchmarkAutocomplete(bookCount, queries);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-fuzzy") {
+         int bookCount = argc > 2 ? stoi(argv[2]) : 1000000;
+         int queries = argc > 3 ? stoi(argv[3]) : 2000;
+         benchmarkFuzzySearch(bookCount, queries);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-isbn") {
+         int bookCount = argc > 2 ? stoi(argv[2]) : 1000000;
+         int lookups = argc > 3 ? stoi(argv[3]) : 1000000;
+         benchmarkIsbnLookup(bookCount, lookups);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-import") {
+         int rows = argc > 2 ? stoi(argv[2]) : 200000;
+         benchmarkCatalogImport(rows);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-search-cache") {
+         int bookCount = argc > 2 ? stoi(argv[2]) : 200000;
+         int queries = argc > 3 ? stoi(argv[3]) : 10000;
+         benchmarkSearchCache(bookCount, queries);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-reports") {
+         int userCount = argc > 2 ? stoi(argv[2]) : 200000;
+         int reports = argc > 3 ? stoi(argv[3]) : 10000;
+         benchmarkCirculationReports(userCount, reports);
+         return 0;
+     }
+     if (argc > 1 && string(argv[1]) == "--bench-export") {
+         int userCount = argc > 2 ? stoi(argv[2]) : 20000;
+         int historyPerUser = argc > 3 ? stoi(argv[3]) : 250;
+         benchmarkExport(userCount, historyPerUser);
+         return 0;
+     }
+     if (argc > 1 && (string(argv[1]) == "--export-jsonl" || string(argv[1]) == "--export-columnar")) {
+         Library lib;
+         lib.loadData();
+         bool ok;
+         if (string(argv[1]) == "--export-jsonl")
+             ok = exportJsonLines(lib, argc > 2 ? argv[2] : "export_");
+         else
+             ok = exportColumnar(lib, argc > 2 ? argv[2] : "export.lmscol");
+         return ok ? 0 : 1;
+     }
+     if (argc > 2 && string(argv[1]) == "--batch") {
+         bool quiet = argc > 3 && string(argv[3]) == "--quiet";
+         VirtualClock clock(getCurrentTimeInMinutes());
+         Library lib;
+         lib.setClock(&clock);
+         lib.loadData();
+         LibraryConsole console(lib);
+         if (lib.getBooksCount() == 0)
+             seedSampleData(console);
+         if (memoryBudget > 0)
+             lib.setMemoryBudget(memoryBudget);
+         int rejected = runBatch(lib, clock, argv[2], quiet);
+         if (rejected < 0)
+             return 1;
+         if (memoryBudget > 0)
+             console.pagingReport();
+         lib.saveData();
+         return rejected == 0 ? 0 : 1;
+     }
+ 
      Library lib;
      lib.loadData();
- 
-     if (lib.getBooksCount() == 0) {
-        lib.addBook("Pattern Recognition and Machine Learning", "Christopher Bishop", "Springer", 2006, "9780387310732");
-        lib.addBook("Machine Learning: A Probabilistic Perspective", "Kevin Murphy", "MIT Press", 2012, "9780262018029");
-        lib.addBook("Deep Learning", "Ian Goodfellow", "MIT Press", 2016, "9780262035613");
-        lib.addBook("The Elements of Statistical Learning", "Trevor Hastie", "Springer", 2009, "9780387848570");
-        lib.addBook("Introduction to Machine Learning with Python", "Andreas Müller", "O'Reilly Media", 2016, "9781449369415");
-        lib.addBook("Hands-On Machine Learning with Scikit-Learn; Keras; and TensorFlow", "Aurélien Géron", "O'Reilly Media", 2019, "9781492032649");
-        lib.addBook("Data Mining: Concepts and Techniques", "Jiawei Han", "Morgan Kaufmann", 2011, "9780123814791");
-        lib.addBook("Reinforcement Learning: An Introduction", "Richard S. Sutton", "MIT Press", 2018, "9780262039246");
-        lib.addBook("Understanding Machine Learning: From Theory to Algorithms", "Shai Shalev-Shwartz", "Cambridge University Press", 2014, "9781107057135");
-        lib.addBook("Artificial Intelligence: A Modern Approach", "Stuart Russell", "Prentice Hall", 2010, "9780136042594");
-        
-        lib.addUser(new Student(1, "Teja",    "teja",    "teja123",    false));
-        lib.addUser(new Student(2, "Obul",      "obul",      "obul123",      false));
-        lib.addUser(new Student(3, "Anirudh",  "anirudh",  "anirudh123",  false));
-        lib.addUser(new Student(4, "Nikhilesh",    "nikhilesh",    "nikhilesh123",    false));
-        lib.addUser(new Student(5, "Satvik",      "satvik",      "satvik123",      false));
-        lib.addUser(new Faculty(6, "Prof. Indranil Saha",    "indranil",    "indranil123",    false));
-        lib.addUser(new Faculty(7, "Prof. Sandeep Shukla",  "sandeep",  "sandeep123",  false));
-        lib.addUser(new Faculty(8, "Prof. Debapriya Basu Roy", "debapriya", "debapriya123", false));
-        lib.addUser(new Librarian(9, "Mr. Tirupati", "tirupati", "tirupati123", false));
+     LibraryConsole console(lib);
+     if (lib.getBooksCount() == 0)
+         seedSampleData(console);
+     if (memoryBudget > 0) {
+         lib.setMemoryBudget(memoryBudget);
+         lib.trimToBudget();
      }
  
      User *currentUser = nullptr;
@@ -59,14 +192,17 @@
              if (!currentUser)
                  cout << "Invalid credentials, please try again." << endl;
          }
+         lib.setActiveUser(currentUser);
  
-         long long currentTime = getCurrentTimeInMinutes();
+         long long currentTime = lib.now();
          if (currentUser->getRole() != "Librarian")
-             lib.checkOverdueNotifications(currentUser, currentTime);
+             console.checkOverdueNotifications(currentUser, currentTime);
  
          bool logout = false;
          while (!logout) {
-             currentTime = getCurrentTimeInMinutes();
+             currentTime = lib.now();
+             lib.expireReservations(currentTime);
+             lib.trimToBudget();
              if (currentUser->getRole() == "Librarian") {
                  showLibrarianMenu();
                  int choice;
@@ -76,18 +212,18 @@
                          printLibrarianHelp();
                          break;
                      case 1:
-                         lib.displayBooks();
+                         console.displayBooks();
                          break;
                      case 2: {
                          cout << "Enter search term: " << flush;
                          string term;
                          cin.ignore();
                          getline(cin, term);
-                         lib.searchBooks(term);
+                         console.searchBooks(term);
                          break;
                      }
                      case 3:
-                         lib.displayUsers();
+                         console.displayUsers();
                          break;
                      case 4: {
                          string title, author, publisher, isbn;
@@ -103,31 +239,31 @@
                          cin >> year;
                          cout << "Enter ISBN: " << flush;
                          cin >> isbn;
-                         lib.addBook(title, author, publisher, year, isbn);
+                         console.addBook(title, author, publisher, year, isbn);
                          break;
                      }
                      case 5: {
                          int bookId;
                          cout << "Enter book ID to remove: " << flush;
                          cin >> bookId;
-                         lib.removeBook(bookId);
+                         console.removeBook(bookId);
                          break;
                      }
                      case 6: {
                          int bookId;
                          cout << "Enter book ID to update: " << flush;
                          cin >> bookId;
-                         lib.updateBookDetails(bookId);
+                         console.updateBookDetails(bookId);
                          break;
                      }
                      case 7:
-                         lib.addNewUser();
+                         console.addNewUser();
                          break;
                      case 8: {
                          int userId;
                          cout << "Enter user ID to remove: " << flush;
                          cin >> userId;
-                         lib.removeUser(userId);
+                         console.removeUser(userId);
                          break;
                      }
                      case 9:
@@ -135,10 +271,57 @@
                          currentUser = nullptr;
                          break;
                      case 10:
-                         currentUser->updateProfile();
+                         console.updateProfile(currentUser);
                          break;
                      case 11:
-                         lib.advancedSearchBooks();
+                         console.advancedSearchBooks();
+                         break;
+                     case 12: {
+                         int days;
+                         cout << "Show items falling due within how many days? " << flush;
+                         cin >> days;
+                         console.overdueReport(currentTime, days);
+                         break;
+                     }
+                     case 13:
+                         console.fineAccrualReport(currentTime);
+                         break;
+                     case 14:
+                         console.returnMany(currentTime);
+                         break;
+                     case 15: {
+                         int bookId;
+                         cout << "Enter book ID: " << flush;
+                         cin >> bookId;
+                         console.showBorrower(bookId);
+                         break;
+                     }
+                     case 16:
+                         console.consistencyReport();
+                         break;
+                     case 17: {
+                         string isbn;
+                         cout << "Enter or scan ISBN: " << flush;
+                         cin >> isbn;
+                         console.findByIsbn(isbn);
+                         break;
+                     }
+                     case 18: {
+                         string path;
+                         cout << "Enter the path of the feed (title,author,publisher,year,ISBN per line): " << flush;
+                         cin.ignore();
+                         getline(cin, path);
+                         console.importCatalog(path);
+                         break;
+                     }
+                     case 19:
+                         console.searchCacheReport();
+                         break;
+                     case 20:
+                         console.circulationReport();
+                         break;
+                     case 21:
+                         console.circulationAnalytics();
                          break;
                      default:
                          cout << "Invalid option. Try again." << endl;
@@ -152,72 +335,87 @@
                          printUserHelp();
                          break;
                      case 1:
-                         lib.displayBooks();
+                         console.displayBooks();
                          break;
                      case 2: {
                          cout << "Enter search term: " << flush;
                          string term;
                          cin.ignore();
                          getline(cin, term);
-                         lib.searchBooks(term);
+                         console.searchBooks(term);
                          break;
                      }
                      case 3: {
                          int bookId;
                          cout << "Enter book ID to borrow: " << flush;
                          cin >> bookId;
-                         lib.borrowBook(currentUser, bookId, currentTime);
+                         console.borrowBook(currentUser, bookId, currentTime);
                          break;
                      }
                      case 4: {
                          int bookId;
                          cout << "Enter reserved book ID to borrow: " << flush;
                          cin >> bookId;
-                         lib.borrowReservedBook(currentUser, bookId, currentTime);
+                         console.borrowReservedBook(currentUser, bookId, currentTime);
                          break;
                      }
                      case 5: {
                          int bookId;
                          cout << "Enter book ID to reserve: " << flush;
                          cin >> bookId;
-                         lib.reserveBook(currentUser, bookId);
+                         console.reserveBook(currentUser, bookId, currentTime);
                          break;
                      }
                      case 6: {
                          int bookId;
                          cout << "Enter book ID to return: " << flush;
                          cin >> bookId;
-                         lib.returnBook(currentUser, bookId, currentTime);
+                         console.returnBook(currentUser, bookId, currentTime);
                          break;
                      }
                      case 7:
-                         lib.displayFullBorrowHistory(currentUser);
+                         console.displayFullBorrowHistory(currentUser);
                          break;
                      case 8:
-                         lib.payFine(currentUser);
+                         console.payFine(currentUser);
                          break;
                      case 9:
                          logout = true;
                          currentUser = nullptr;
                          break;
                      case 10:
-                         currentUser->updateProfile();
+                         console.updateProfile(currentUser);
                          break;
                      case 11:
-                         lib.advancedSearchBooks();
+                         console.advancedSearchBooks();
                          break;
                      case 12: {
                          int bookId;
                          cout << "Enter book ID to renew: " << flush;
                          cin >> bookId;
-                         lib.renewBook(currentUser, bookId, currentTime);
+                         console.renewBook(currentUser, bookId, currentTime);
                          break;
                      }
                      case 13: {
                          int bookId;
                          cout << "Enter book ID to cancel reservation: " << flush;
                          cin >> bookId;
-                         lib.cancelReservation(currentUser, bookId);
+                         console.cancelReservation(currentUser, bookId);
+                         break;
+                     }
+                     case 14: {
+                         cout << "Type the start of a title or author: " << flush;
+                         string text;
+                         cin.ignore();
+                         getline(cin, text);
+                         console.autocomplete(text);
+                         break;
+                     }
+                     case 15: {
+                         string isbn;
+                         cout << "Enter or scan ISBN: " << flush;
+                         cin >> isbn;
+                         console.borrowByIsbn(currentUser, isbn, currentTime);
                          break;
                      }
                      default:
@@ -231,10 +429,35 @@
          if (exitChoice == 'y' || exitChoice == 'Y')
              exitProgram = true;
      }
+     if (memoryBudget > 0)
+         console.pagingReport();
      lib.saveData();
      return 0;
  }
  
+ void seedSampleData(LibraryConsole &console) {
+     console.addBook("Pattern Recognition and Machine Learning", "Christopher Bishop", "Springer", 2006, "9780387310732");
+     console.addBook("Machine Learning: A Probabilistic Perspective", "Kevin Murphy", "MIT Press", 2012, "9780262018029");
+     console.addBook("Deep Learning", "Ian Goodfellow", "MIT Press", 2016, "9780262035613");
+     console.addBook("The Elements of Statistical Learning", "Trevor Hastie", "Springer", 2009, "9780387848570");
+     console.addBook("Introduction to Machine Learning with Python", "Andreas Müller", "O'Reilly Media", 2016, "9781449369415");
+     console.addBook("Hands-On Machine Learning with Scikit-Learn; Keras; and TensorFlow", "Aurélien Géron", "O'Reilly Media", 2019, "9781492032649");
+     console.addBook("Data Mining: Concepts and Techniques", "Jiawei Han", "Morgan Kaufmann", 2011, "9780123814791");
+     console.addBook("Reinforcement Learning: An Introduction", "Richard S. Sutton", "MIT Press", 2018, "9780262039246");
+     console.addBook("Understanding Machine Learning: From Theory to Algorithms", "Shai Shalev-Shwartz", "Cambridge University Press", 2014, "9781107057135");
+     console.addBook("Artificial Intelligence: A Modern Approach", "Stuart Russell", "Prentice Hall", 2010, "9780136042594");
+
+     console.addUser(new Student(1, "Teja",    "teja",    "teja123",    false));
+     console.addUser(new Student(2, "Obul",      "obul",      "obul123",      false));
+     console.addUser(new Student(3, "Anirudh",  "anirudh",  "anirudh123",  false));
+     console.addUser(new Student(4, "Nikhilesh",    "nikhilesh",    "nikhilesh123",    false));
+     console.addUser(new Student(5, "Satvik",      "satvik",      "satvik123",      false));
+     console.addUser(new Faculty(6, "Prof. Indranil Saha",    "indranil",    "indranil123",    false));
+     console.addUser(new Faculty(7, "Prof. Sandeep Shukla",  "sandeep",  "sandeep123",  false));
+     console.addUser(new Faculty(8, "Prof. Debapriya Basu Roy", "debapriya", "debapriya123", false));
+     console.addUser(new Librarian(9, "Mr. Tirupati", "tirupati", "tirupati123", false));
+ }
+ 
  void printUserHelp() {
      cout << endl
           << "User Help:" << endl
@@ -251,7 +474,9 @@
           << "10: Update Profile." << endl
           << "11: Advanced Search." << endl
           << "12: Renew a Book." << endl
-          << "13: Cancel Reservation." << endl;
+          << "13: Cancel Reservation." << endl
+          << "14: Quick Search - Complete a few typed letters into the most popular matching books." << endl
+          << "15: Borrow by ISBN - Borrow an available copy from its ISBN or barcode." << endl;
  }
  
  void printLibrarianHelp() {
@@ -268,7 +493,17 @@
           << "8: Remove a user." << endl
           << "9: Logout." << endl
           << "10: Update Profile." << endl
-          << "11: Advanced Search." << endl;
+          << "11: Advanced Search." << endl
+          << "12: Overdue Report - List overdue items and items falling due soon." << endl
+          << "13: Projected Fines - Show fines accrued so far on books still out." << endl
+          << "14: Book-Drop Returns - Return a stack of books in one batch." << endl
+          << "15: Who Has This Book - Show the current borrower of a book." << endl
+          << "16: Consistency Check - Cross-check loans, book statuses and reservations." << endl
+          << "17: Find by ISBN - List every copy with an ISBN or barcode." << endl
+          << "18: Import Catalog Feed - Add every new title from a vendor CSV feed in one batch." << endl
+          << "19: Search Cache Statistics - Show how often repeated searches were answered from the cache." << endl
+          << "20: Circulation Report - Outstanding fines, loans per role, reserved books and this month's most borrowed books." << endl
+          << "21: Circulation Analytics - Loans per week, average loan length, late returns and fines over the whole history." << endl;
  }
  
  void showUserMenu() {
@@ -288,6 +523,8 @@
           << "11. Advanced Search" << endl
           << "12. Renew a Book" << endl
           << "13. Cancel Reservation" << endl
+          << "14. Quick Search" << endl
+          << "15. Borrow by ISBN" << endl
           << "Enter your choice: " << flush;
  }
  
@@ -306,6 +543,16 @@
           << "9. Logout" << endl
           << "10. Update Profile" << endl
           << "11. Advanced Search" << endl
+          << "12. Overdue Report" << endl
+          << "13. Projected Fines" << endl
+          << "14. Book-Drop Returns" << endl
+          << "15. Who Has This Book" << endl
+          << "16. Consistency Check" << endl
+          << "17. Find by ISBN" << endl
+          << "18. Import Catalog Feed" << endl
+          << "19. Search Cache Statistics" << endl
+          << "20. Circulation Report" << endl
+          << "21. Circulation Analytics" << endl
           << "Enter your choice: " << flush;
  }
  
\ No newline at end of file
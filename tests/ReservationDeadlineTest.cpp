@@ -0,0 +1,71 @@
+/*
+ * ReservationDeadlineTest.cpp
+ *
+ * This file checks that a reservation can be collected up to and including
+ * its last minute and has expired one minute later, whether the desk sees it
+ * first (borrowReservedBook) or the timing wheel does (expireReservations).
+ * It runs in a fresh temporary directory and exits non-zero on the first
+ * failure.
+ */
+
+#include "../Library.h"
+#include "../Utility.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+using namespace std;
+
+namespace {
+
+const long long START = 29000000;
+const long long RESERVATION_PERIOD = 7LL * 24 * 60;
+
+int failures = 0;
+
+void check(bool ok, const string &what) {
+    if (!ok) {
+        cerr << "FAILED: " << what << endl;
+        failures++;
+    }
+}
+
+// Runs one case: the holder's window opens at START, when the book comes
+// back, and the holder tries to collect it at collectTime, optionally after
+// the wheel has been advanced to that minute.
+OpStatus collectAt(long long collectTime, bool runWheel) {
+    VirtualClock clock(START);
+    Library lib;
+    lib.setClock(&clock);
+    lib.addBook("Reserved Title", "Author", "Press", 2000, "");
+    User *borrower = new Student(1, "Borrower", "borrower", "pwd", true);
+    User *holder = new Student(2, "Holder", "holder", "pwd", true);
+    lib.addUser(borrower);
+    lib.addUser(holder);
+    lib.borrowBook(borrower, 1, START - 60);
+    lib.reserveBook(holder, 1, START - 30);
+    lib.returnBook(borrower, 1, START);
+    clock.set(collectTime);
+    if (runWheel)
+        lib.expireReservations(collectTime);
+    return lib.borrowReservedBook(holder, 1, collectTime);
+}
+
+}
+
+int main() {
+    char dir[] = "/tmp/lms-test-XXXXXX";
+    if (!mkdtemp(dir) || chdir(dir) != 0) {
+        cerr << "Cannot create a temporary directory" << endl;
+        return 1;
+    }
+    setTransactionLogging(false);
+    long long lastMinute = START + RESERVATION_PERIOD;
+    check(collectAt(lastMinute, false) == OP_OK, "desk allows collection at the last minute");
+    check(collectAt(lastMinute, true) == OP_OK, "wheel keeps the hold at the last minute");
+    check(collectAt(lastMinute + 1, false) == OP_RESERVATION_EXPIRED, "desk expires the hold a minute later");
+    check(collectAt(lastMinute + 1, true) == OP_NOT_RESERVED_BY_USER, "wheel releases the hold a minute later");
+    if (failures == 0)
+        cout << "ReservationDeadlineTest passed" << endl;
+    return failures == 0 ? 0 : 1;
+}